@@ -0,0 +1,470 @@
+/**
+ * File: life-bench.cpp
+ * --------------------
+ * Headless benchmarks for the Game of Life engines.
+ *
+ *   life-bench scaling [--rows R] [--cols C] [--generations G]
+ *                      [--max-threads T] [--density D] [--rule B3/S23]
+ *
+ * Runs the parallel engine on a random board with 1, 2, 4, ... threads
+ * (up to the hardware thread count by default) and reports cells/second
+ * and the speedup over a single thread.
+ *
+ *   life-bench batch [--rows R] [--cols C] [--generations G]
+ *                    [--engines a,b,...] [--format csv|json]
+ *                    [--rule B3/S23] pattern...
+ *
+ * Loads each pattern file (the res/files format), centres it on an
+ * R x C board (grown to fit the pattern if needed) and runs G generations
+ * on every listed engine, all of them by default, each run in a child
+ * process of its own.  One record per run is printed with
+ * generations/second, cells/second, the peak resident set size of that
+ * run and the hash of the final live cells.  Engines confined to the
+ * board lose cells that reach its edge while unbounded ones keep them,
+ * so hashes are only compared among engines of the same kind; a hash
+ * that differs from the first of its kind is reported and counts as a
+ * failure.
+ *
+ * Both modes run Conway's B3/S23 unless --rule names another two-state
+ * rule without B0, such as B36/S23.
+ */
+
+#include <sys/resource.h> // for getrusage
+#include <sys/wait.h>     // for waitpid
+#include <unistd.h>       // for fork, pipe
+
+#include <cerrno>  // for errno, ERANGE
+#include <chrono>
+#include <climits> // for INT_MAX, INT_MIN
+#include <cstdlib> // for strtod, strtol
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "life-engine.h"
+#include "life-parallel.h"
+#include "life-pattern.h"
+
+struct BenchOptions {
+  int rows = 4096;
+  int cols = 4096;
+  int generations = 100;
+  int maxThreads = 0;
+  double density = 0.3;
+  vector<string> engines;
+  string format = "csv";
+  LifeRule rule;
+  vector<string> patterns;
+};
+
+static void usage() {
+  cerr << "usage: life-bench scaling [--rows R] [--cols C] [--generations G]"
+       << endl
+       << "                          [--max-threads T] [--density D]"
+       << " [--rule R]" << endl
+       << "       life-bench batch [--rows R] [--cols C] [--generations G]"
+       << endl
+       << "                        [--engines a,b,...] [--format csv|json]"
+       << " [--rule R]" << endl
+       << "                        pattern..." << endl;
+}
+
+/*
+ * Each of these stores the whole of value, read as a decimal number, in
+ * result and returns true, or returns false if value holds anything else
+ * or a number out of result's range.
+ */
+static bool parseInt(const string &value, int &result) {
+  char *end;
+  errno = 0;
+  long number = strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || errno == ERANGE || number < INT_MIN ||
+      number > INT_MAX) {
+    return false;
+  }
+  result = int(number);
+  return true;
+}
+
+static bool parseDouble(const string &value, double &result) {
+  char *end;
+  errno = 0;
+  double number = strtod(value.c_str(), &end);
+  if (value.empty() || *end != '\0' || errno == ERANGE) {
+    return false;
+  }
+  result = number;
+  return true;
+}
+
+static bool parseOptions(int argc, char **argv, int first,
+                         BenchOptions &options) {
+  for (int i = first; i < argc; i++) {
+    string flag = argv[i];
+    if (flag.compare(0, 2, "--") != 0) {
+      options.patterns.push_back(flag);
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << flag << " needs a value" << endl;
+      return false;
+    }
+    string value = argv[++i];
+    bool number = true;
+    if (flag == "--rows") {
+      number = parseInt(value, options.rows);
+    } else if (flag == "--cols") {
+      number = parseInt(value, options.cols);
+    } else if (flag == "--generations") {
+      number = parseInt(value, options.generations);
+    } else if (flag == "--max-threads") {
+      number = parseInt(value, options.maxThreads);
+    } else if (flag == "--density") {
+      number = parseDouble(value, options.density);
+    } else if (flag == "--engines") {
+      options.engines.clear();
+      size_t start = 0;
+      while (start <= value.size()) {
+        size_t comma = min(value.find(',', start), value.size());
+        options.engines.push_back(value.substr(start, comma - start));
+        start = comma + 1;
+      }
+    } else if (flag == "--format") {
+      options.format = value;
+    } else if (flag == "--rule") {
+      string error;
+      if (!LifeRule::parse(value, options.rule, error)) {
+        cerr << error << endl;
+        return false;
+      }
+    } else {
+      cerr << "unknown option " << flag << endl;
+      return false;
+    }
+    if (!number) {
+      cerr << flag << " needs a number, not " << value << endl;
+      return false;
+    }
+  }
+  return options.rows > 0 && options.cols > 0 && options.generations > 0 &&
+         options.density >= 0 && options.density <= 1 &&
+         (options.format == "csv" || options.format == "json");
+}
+
+static void fillRandom(LifeEngine &engine, const BenchOptions &options) {
+  mt19937 generator(106);
+  bernoulli_distribution alive(options.density);
+  engine.setDimensions(options.rows, options.cols);
+  for (int row = 0; row < options.rows; row++) {
+    for (int col = 0; col < options.cols; col++) {
+      if (alive(generator)) {
+        engine.setAge(row, col, 1);
+      }
+    }
+  }
+}
+
+// returns the seconds taken to run the given number of generations
+static double timeGenerations(LifeEngine &engine, int generations) {
+  auto start = chrono::steady_clock::now();
+  for (int generation = 0; generation < generations; generation++) {
+    engine.evolve();
+  }
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+static int runScaling(const BenchOptions &options) {
+  int maxThreads = options.maxThreads;
+  if (maxThreads <= 0) {
+    maxThreads = max(1, (int)thread::hardware_concurrency());
+  }
+  vector<int> counts;
+  for (int threads = 1; threads < maxThreads; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(maxThreads);
+
+  double cells = double(options.rows) * options.cols * options.generations;
+  double baseline = 0;
+  cout << "board " << options.rows << "x" << options.cols << ", "
+       << options.generations << " generations of "
+       << options.rule.toString() << endl;
+  cout << setw(8) << "threads" << setw(12) << "seconds" << setw(16)
+       << "cells/sec" << setw(10) << "speedup" << endl;
+  for (int threads : counts) {
+    ParallelLifeEngine engine(threads);
+    string error;
+    if (!engine.setRule(options.rule, error)) {
+      cerr << error << endl;
+      return 1;
+    }
+    fillRandom(engine, options);
+    engine.evolve(); // warm up the pool and the caches
+    double seconds = timeGenerations(engine, options.generations);
+    if (baseline == 0) {
+      baseline = seconds;
+    }
+    cout << setw(8) << threads << setw(12) << fixed << setprecision(3)
+         << seconds << setw(16) << scientific << setprecision(3)
+         << cells / seconds << setw(10) << fixed << setprecision(2)
+         << baseline / seconds << endl;
+  }
+  return 0;
+}
+
+// peak resident set size of this process so far, in kilobytes
+static long peakResidentKilobytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024; // reported in bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+// copies the pattern into the middle of the engine's board
+static void placePattern(LifeEngine &engine, const LifeBitmap &pattern,
+                         int rows, int cols) {
+  engine.setDimensions(rows, cols);
+  int top = (rows - pattern.numRows()) / 2;
+  int left = (cols - pattern.numCols()) / 2;
+  for (int row = 0; row < pattern.numRows(); row++) {
+    const uint64_t *words = pattern.row(row);
+    for (int w = 0; w < pattern.wordsPerRow(); w++) {
+      uint64_t live = words[w];
+      while (live != 0) {
+        int bit = __builtin_ctzll(live);
+        live &= live - 1;
+        engine.setAge(top + row, left + w * 64 + bit, 1);
+      }
+    }
+  }
+}
+
+static string baseName(const string &path) {
+  size_t slash = path.find_last_of("/\\");
+  return slash == string::npos ? path : path.substr(slash + 1);
+}
+
+static string jsonString(const string &text) {
+  string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"' || ch == '\\') {
+      quoted += '\\';
+    }
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+static string csvField(const string &text) {
+  if (text.find_first_of(",\"") == string::npos) {
+    return text;
+  }
+  string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"') {
+      quoted += '"';
+    }
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+struct BatchRecord {
+  string pattern;
+  string engine;
+  int rows;
+  int cols;
+  int generations;
+  double seconds;
+  long peakKilobytes;
+  uint64_t liveHash;
+};
+
+static void printRecord(const BatchRecord &record, const string &format,
+                        bool first) {
+  double generationsPerSecond = record.generations / record.seconds;
+  double cellsPerSecond =
+      double(record.rows) * record.cols * generationsPerSecond;
+  ostringstream hash;
+  hash << hex << setw(16) << setfill('0') << record.liveHash;
+  if (format == "csv") {
+    cout << csvField(record.pattern) << "," << record.engine << ","
+         << record.rows << "," << record.cols << "," << record.generations
+         << "," << fixed << setprecision(6) << record.seconds << ","
+         << setprecision(1) << generationsPerSecond << "," << scientific
+         << setprecision(4) << cellsPerSecond << "," << record.peakKilobytes
+         << "," << hash.str() << endl;
+  } else {
+    cout << (first ? "  " : ",\n  ") << "{\"pattern\": "
+         << jsonString(record.pattern) << ", \"engine\": "
+         << jsonString(record.engine) << ", \"rows\": " << record.rows
+         << ", \"cols\": " << record.cols
+         << ", \"generations\": " << record.generations
+         << ", \"seconds\": " << fixed << setprecision(6) << record.seconds
+         << ", \"gens_per_sec\": " << setprecision(1) << generationsPerSecond
+         << ", \"cells_per_sec\": " << scientific << setprecision(4)
+         << cellsPerSecond << ", \"peak_rss_kb\": " << record.peakKilobytes
+         << ", \"live_hash\": \"" << hash.str() << "\"}";
+  }
+}
+
+// what a run in a child process sends back through its pipe
+struct RunMeasurement {
+  double seconds;
+  long peakKilobytes;
+  uint64_t liveHash;
+};
+
+/*
+ * Runs the engine on the pattern in a child process, so the peak
+ * resident set size is that run's alone, and returns its measurement
+ * through a pipe, or returns false if the child could not be run.
+ */
+static bool measure(const string &name, const BenchOptions &options,
+                    const LifeBitmap &pattern, int rows, int cols,
+                    RunMeasurement &measurement) {
+  int channel[2];
+  if (pipe(channel) != 0) {
+    return false;
+  }
+  pid_t child = fork();
+  if (child < 0) {
+    close(channel[0]);
+    close(channel[1]);
+    return false;
+  }
+  if (child == 0) {
+    close(channel[0]);
+    unique_ptr<LifeEngine> engine = createLifeEngine(name);
+    string error;
+    engine->setRule(options.rule, error);
+    placePattern(*engine, pattern, rows, cols);
+    RunMeasurement measured;
+    measured.seconds = timeGenerations(*engine, options.generations);
+    measured.peakKilobytes = peakResidentKilobytes();
+    measured.liveHash = engine->getLiveHash();
+    bool sent = write(channel[1], &measured, sizeof(measured)) ==
+                ssize_t(sizeof(measured));
+    _exit(sent ? 0 : 1);
+  }
+  close(channel[1]);
+  bool received = read(channel[0], &measurement, sizeof(measurement)) ==
+                  ssize_t(sizeof(measurement));
+  close(channel[0]);
+  int status;
+  waitpid(child, &status, 0);
+  return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int runBatch(const BenchOptions &options) {
+  if (options.patterns.empty()) {
+    cerr << "batch needs at least one pattern file" << endl;
+    return 1;
+  }
+  vector<string> engines = options.engines;
+  if (engines.empty()) {
+    engines = getLifeEngineNames();
+  }
+  vector<bool> unbounded;
+  for (const string &name : engines) {
+    unique_ptr<LifeEngine> engine = createLifeEngine(name);
+    string error;
+    if (!engine) {
+      cerr << name << " is not a known engine" << endl;
+      return 1;
+    }
+    if (!engine->setRule(options.rule, error)) {
+      cerr << error << endl;
+      return 1;
+    }
+    unbounded.push_back(engine->isUnbounded());
+  }
+
+  if (options.format == "csv") {
+    cout << "pattern,engine,rows,cols,generations,seconds,gens_per_sec,"
+         << "cells_per_sec,peak_rss_kb,live_hash" << endl;
+  } else {
+    cout << "[" << endl;
+  }
+  bool first = true;
+  int failures = 0;
+  for (const string &path : options.patterns) {
+    LifeBitmap pattern;
+    string error;
+    if (!readLifePattern(path, pattern, error)) {
+      cerr << error << endl;
+      failures++;
+      continue;
+    }
+    int rows = max(options.rows, pattern.numRows());
+    int cols = max(options.cols, pattern.numCols());
+    // the first engine of each kind, bounded and unbounded, to finish
+    int reference[2] = {-1, -1};
+    uint64_t referenceHash[2] = {0, 0};
+    for (size_t i = 0; i < engines.size(); i++) {
+      const string &name = engines[i];
+      RunMeasurement measurement;
+      if (!measure(name, options, pattern, rows, cols, measurement)) {
+        cerr << name << " could not be run on " << path << endl;
+        failures++;
+        continue;
+      }
+      int kind = unbounded[i] ? 1 : 0;
+      if (reference[kind] == -1) {
+        reference[kind] = int(i);
+        referenceHash[kind] = measurement.liveHash;
+      } else if (measurement.liveHash != referenceHash[kind]) {
+        cerr << name << " and " << engines[reference[kind]]
+             << " disagree on the live cells of " << path << endl;
+        failures++;
+      }
+      BatchRecord record;
+      record.pattern = baseName(path);
+      record.engine = name;
+      record.rows = rows;
+      record.cols = cols;
+      record.generations = options.generations;
+      record.seconds = measurement.seconds;
+      record.peakKilobytes = measurement.peakKilobytes;
+      record.liveHash = measurement.liveHash;
+      printRecord(record, options.format, first);
+      first = false;
+    }
+  }
+  if (options.format == "json") {
+    cout << (first ? "]" : "\n]") << endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+  string mode = argv[1];
+  BenchOptions options;
+  if (!parseOptions(argc, argv, 2, options)) {
+    usage();
+    return 1;
+  }
+  if (mode == "scaling") {
+    return runScaling(options);
+  }
+  if (mode == "batch") {
+    return runBatch(options);
+  }
+  usage();
+  return 1;
+}
@@ -0,0 +1,39 @@
+#####################################################################
+## Headless benchmark for the Game of Life engines                 ##
+#####################################################################
+#
+# Builds a console program that drives the engines in ../src without
+# any graphics, so neither Qt nor the Stanford library is needed:
+#
+#     cd bench && qmake life-bench.pro && make
+#     ./life-bench scaling
+#     ./life-bench batch --format json ../res/files/*
+#
+# Only engine sources belong here; life.cpp and life-graphics.cpp need
+# the full Stanford library and are built by game-of-life.pro instead.
+
+TEMPLATE = app
+TARGET = life-bench
+CONFIG += console c++14
+CONFIG -= qt app_bundle
+
+INCLUDEPATH *= $$PWD/../src/
+
+SOURCES *= $$PWD/life-bench.cpp
+SOURCES *= $$PWD/../src/life-bitmap.cpp
+SOURCES *= $$PWD/../src/life-engine.cpp
+SOURCES *= $$PWD/../src/life-hashlife.cpp
+SOURCES *= $$PWD/../src/life-packed.cpp
+SOURCES *= $$PWD/../src/life-parallel.cpp
+SOURCES *= $$PWD/../src/life-pattern.cpp
+SOURCES *= $$PWD/../src/life-rule.cpp
+SOURCES *= $$PWD/../src/life-sparse.cpp
+SOURCES *= $$PWD/../src/life-threadpool.cpp
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Wno-sign-compare
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+LIBS += -lpthread
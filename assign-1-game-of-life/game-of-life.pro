@@ -465,6 +465,9 @@ CONFIG(debug, debug|release) {
 
     # print details about uncaught exceptions with red error text / stack trace
     DEFINES += SPL_CONSOLE_PRINT_EXCEPTIONS
+
+    # bounds-check rows and cells reached through GridView and Grid::rowData
+    DEFINES += SPL_GRID_CHECK_VIEWS
 }
 
 # make 'release' target be statically linked so it is a stand-alone executable
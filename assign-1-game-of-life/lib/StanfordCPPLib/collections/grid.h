@@ -4,6 +4,11 @@
  * This file exports the <code>Grid</code> class, which offers a
  * convenient abstraction for representing a two-dimensional array.
  *
+ * This copy is not the stock library header: the Game of Life project
+ * adds GridView, a non-owning view of a grid's rows or of a sub-grid,
+ * the Grid methods rowData, view and subGrid that return one, and the
+ * forEachStencil helper that walks a view a 3x3 neighbourhood at a time.
+ *
  * @version 2018/03/12
  * - added overloads that accept GridLocation: get, inBounds, locations, set, operator []
  * @version 2018/03/10
@@ -71,6 +76,129 @@
 #include "vector.h"
 #undef INTERNAL_INCLUDE
 
+/*
+ * Class: GridView<ValueType>
+ * --------------------------
+ * This class is a window onto a rectangle of elements stored row by row,
+ * such as all or part of a <code>Grid</code>.  A view does not own or
+ * copy the elements; each row is a contiguous array reached through a
+ * plain pointer, so loops over a view compile to simple array code.
+ * A <code>GridView&lt;const T&gt;</code> gives read-only access.
+ *
+ * Accesses through a view are only bounds-checked when the library is
+ * built with <code>SPL_GRID_CHECK_VIEWS</code> defined, as debug builds
+ * are.  A view is invalidated by anything that resizes the grid it
+ * looks into, and writes through it do not count as modifications for
+ * the purpose of detecting invalid iterators.
+ */
+template <typename ValueType>
+class GridView {
+public:
+    /*
+     * Constructor: GridView
+     * Usage: GridView<int> view(data, nRows, nCols, stride);
+     * ------------------------------------------------------
+     * Creates a view of nRows x nCols elements whose first row starts at
+     * data and whose rows are <code>stride</code> elements apart.
+     */
+    GridView() : data(nullptr), nRows(0), nCols(0), rowStride(0) {}
+    GridView(ValueType* data, int nRows, int nCols, int stride)
+            : data(data), nRows(nRows), nCols(nCols), rowStride(stride) {}
+
+    /*
+     * A view of mutable elements converts to a read-only view.
+     */
+    template <typename OtherType>
+    GridView(const GridView<OtherType>& other)
+            : data(other.rowData(0)),
+              nRows(other.numRows()),
+              nCols(other.numCols()),
+              rowStride(other.stride()) {}
+
+    int numRows() const { return nRows; }
+    int numCols() const { return nCols; }
+    bool isEmpty() const { return nRows == 0 || nCols == 0; }
+
+    /*
+     * Method: stride
+     * Usage: int stride = view.stride();
+     * ----------------------------------
+     * Returns the distance, in elements, from the start of one row of the
+     * view to the start of the next.
+     */
+    int stride() const { return rowStride; }
+
+    /*
+     * Method: rowData
+     * Usage: ValueType* cells = view.rowData(row);
+     * --------------------------------------------
+     * Returns a pointer to the <code>numCols()</code> contiguous elements
+     * of the given row of the view.
+     */
+    ValueType* rowData(int row) const {
+#ifdef SPL_GRID_CHECK_VIEWS
+        if (row < 0 || (row >= nRows && nRows > 0)) {
+            error("GridView::rowData: row " + integerToString(row)
+                  + " is outside of valid range [0.." + integerToString(nRows - 1) + "]");
+        }
+#endif // SPL_GRID_CHECK_VIEWS
+        return data + static_cast<long>(row) * rowStride;
+    }
+
+    /*
+     * Operator: []
+     * Usage: view[row][col]
+     * ---------------------
+     * Selects a row of the view as a plain pointer, so the column is not
+     * checked even when rows are.
+     */
+    ValueType* operator [](int row) const {
+        return rowData(row);
+    }
+
+    /*
+     * Operator: ()
+     * Usage: view(row, col)
+     * ---------------------
+     * Returns the element at the given position of the view.
+     */
+    ValueType& operator ()(int row, int col) const {
+#ifdef SPL_GRID_CHECK_VIEWS
+        if (col < 0 || col >= nCols) {
+            error("GridView::operator (): column " + integerToString(col)
+                  + " is outside of valid range [0.." + integerToString(nCols - 1) + "]");
+        }
+#endif // SPL_GRID_CHECK_VIEWS
+        return rowData(row)[col];
+    }
+
+    /*
+     * Method: subView
+     * Usage: GridView<ValueType> part = view.subView(row, col, nRows, nCols);
+     * -----------------------------------------------------------------------
+     * Returns the view of the nRows x nCols rectangle whose upper-left
+     * corner is at (row, col) of this view.  Signals an error if the
+     * rectangle does not fit inside this view.
+     */
+    GridView subView(int row, int col, int nRows, int nCols) const {
+        if (row < 0 || col < 0 || nRows < 0 || nCols < 0
+                || row + nRows > this->nRows || col + nCols > this->nCols) {
+            error("GridView::subView: " + integerToString(nRows) + "x"
+                  + integerToString(nCols) + " at (" + integerToString(row) + ", "
+                  + integerToString(col) + ") does not fit in "
+                  + integerToString(this->nRows) + "x" + integerToString(this->nCols));
+        }
+        return GridView(data + static_cast<long>(row) * rowStride + col,
+                        nRows, nCols, rowStride);
+    }
+
+private:
+    ValueType* data;
+    int nRows;
+    int nCols;
+    int rowStride;
+};
+
 /*
  * Class: Grid<ValueType>
  * ----------------------
@@ -275,6 +403,18 @@ public:
      */
     int numRows() const;
 
+    /*
+     * Method: rowData
+     * Usage: ValueType* cells = grid.rowData(row);
+     * --------------------------------------------
+     * Returns a pointer to the <code>numCols()</code> contiguous elements
+     * of the given row.  Unlike <code>grid[row][col]</code>, indexing the
+     * pointer is never checked, and the row itself is only checked when
+     * <code>SPL_GRID_CHECK_VIEWS</code> is defined.
+     */
+    ValueType* rowData(int row);
+    const ValueType* rowData(int row) const;
+
     /*
      * Method: resize
      * Usage: grid.resize(nRows, nCols);
@@ -308,6 +448,17 @@ public:
      */
     int size() const;
 
+    /*
+     * Method: subGrid
+     * Usage: GridView<ValueType> part = grid.subGrid(row, col, nRows, nCols);
+     * -----------------------------------------------------------------------
+     * Returns a view of the nRows x nCols rectangle of this grid whose
+     * upper-left corner is at (row, col), without copying any elements.
+     * Signals an error if the rectangle does not fit inside the grid.
+     */
+    GridView<ValueType> subGrid(int row, int col, int nRows, int nCols);
+    GridView<const ValueType> subGrid(int row, int col, int nRows, int nCols) const;
+
     /*
      * Method: toString
      * Usage: string str = grid.toString();
@@ -334,6 +485,15 @@ public:
             std::string colSeparator = ", ",
             std::string rowSeparator = ",\n ") const;
 
+    /*
+     * Method: view
+     * Usage: GridView<ValueType> all = grid.view();
+     * ---------------------------------------------
+     * Returns a view of the whole grid, without copying any elements.
+     */
+    GridView<ValueType> view();
+    GridView<const ValueType> view() const;
+
     /*
      * Method: width
      * Usage: int nCols = grid.width();
@@ -904,6 +1064,16 @@ void Grid<ValueType>::resize(int numRows, int numCols, bool retain) {
     m_version++;
 }
 
+template <typename ValueType>
+ValueType* Grid<ValueType>::rowData(int row) {
+    return view().rowData(row);
+}
+
+template <typename ValueType>
+const ValueType* Grid<ValueType>::rowData(int row) const {
+    return view().rowData(row);
+}
+
 template <typename ValueType>
 void Grid<ValueType>::set(int row, int col, const ValueType& value) {
     checkIndexes(row, col, nRows - 1, nCols - 1, "set");
@@ -921,6 +1091,16 @@ int Grid<ValueType>::size() const {
     return nRows * nCols;
 }
 
+template <typename ValueType>
+GridView<ValueType> Grid<ValueType>::subGrid(int row, int col, int nRows, int nCols) {
+    return view().subView(row, col, nRows, nCols);
+}
+
+template <typename ValueType>
+GridView<const ValueType> Grid<ValueType>::subGrid(int row, int col, int nRows, int nCols) const {
+    return view().subView(row, col, nRows, nCols);
+}
+
 template <typename ValueType>
 std::string Grid<ValueType>::toString() const {
     std::ostringstream os;
@@ -958,6 +1138,16 @@ std::string Grid<ValueType>::toString2D(
     return os.str();
 }
 
+template <typename ValueType>
+GridView<ValueType> Grid<ValueType>::view() {
+    return GridView<ValueType>(elements, nRows, nCols, nCols);
+}
+
+template <typename ValueType>
+GridView<const ValueType> Grid<ValueType>::view() const {
+    return GridView<const ValueType>(elements, nRows, nCols, nCols);
+}
+
 template <typename ValueType>
 int Grid<ValueType>::width() const {
     return nCols;
@@ -1145,6 +1335,43 @@ const T& randomElement(const Grid<T>& grid) {
     return grid.get(row, col);
 }
 
+/*
+ * Function: forEachStencil
+ * Usage: forEachStencil(view, interiorFn, borderFn);
+ * --------------------------------------------------
+ * Walks every cell of the view in row-major order for a computation that
+ * reads each cell's 3x3 neighbourhood.  Cells with all eight neighbours
+ * inside the view are handed over a row at a time, as
+ *
+ *    interiorFn(row, firstCol, endCol, above, current, below)
+ *
+ * where <code>above</code>, <code>current</code> and <code>below</code>
+ * point to rows row - 1, row and row + 1, and columns firstCol - 1
+ * through endCol of all three may be read without any check.  A loop
+ * over [firstCol, endCol) then needs no bounds tests and can be
+ * vectorized by the compiler.  Each cell on the edge of the view is
+ * passed to <code>borderFn(row, col)</code> instead, which must handle
+ * its missing neighbours itself.
+ */
+template <typename ValueType, typename InteriorFunction, typename BorderFunction>
+void forEachStencil(GridView<ValueType> view, InteriorFunction interiorFn,
+                    BorderFunction borderFn) {
+    int nRows = view.numRows();
+    int nCols = view.numCols();
+    for (int row = 0; row < nRows; row++) {
+        if (row == 0 || row == nRows - 1 || nCols < 3) {
+            for (int col = 0; col < nCols; col++) {
+                borderFn(row, col);
+            }
+            continue;
+        }
+        borderFn(row, 0);
+        interiorFn(row, 1, nCols - 1, view.rowData(row - 1), view.rowData(row),
+                   view.rowData(row + 1));
+        borderFn(row, nCols - 1);
+    }
+}
+
 /*
  * Randomly rearranges the elements of the given grid.
  */
@@ -0,0 +1,39 @@
+/**
+ * File: life-bitmap.cpp
+ * ---------------------
+ * Implements the bit-packed liveness plane.
+ */
+
+#include "life-bitmap.h"
+
+#include <algorithm>
+#include <utility>
+using namespace std;
+
+LifeBitmap::LifeBitmap()
+    : rows(0), cols(0), words(0), stride(2), lastMask(0) {}
+
+void LifeBitmap::resize(int rows, int cols) {
+  this->rows = rows;
+  this->cols = cols;
+  words = (cols + 63) / 64;
+  stride = words + 2;
+  lastMask = (cols % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (cols % 64)) - 1;
+  // assign keeps the old capacity when it is large enough
+  bits.assign(size_t(rows + 2) * stride, 0);
+}
+
+void LifeBitmap::clear() { fill(bits.begin(), bits.end(), 0); }
+
+void LifeBitmap::swap(LifeBitmap &other) {
+  std::swap(rows, other.rows);
+  std::swap(cols, other.cols);
+  std::swap(words, other.words);
+  std::swap(stride, other.stride);
+  std::swap(lastMask, other.lastMask);
+  bits.swap(other.bits);
+}
+
+bool LifeBitmap::operator==(const LifeBitmap &other) const {
+  return rows == other.rows && cols == other.cols && bits == other.bits;
+}
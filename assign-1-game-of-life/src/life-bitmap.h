@@ -0,0 +1,80 @@
+/**
+ * File: life-bitmap.h
+ * -------------------
+ * Defines a bit-packed liveness plane for the Game of Life.  Each
+ * row is stored as 64-bit words (column c lives in bit c % 64 of
+ * word c / 64), surrounded by one word of zero padding on each side
+ * and one row of zero padding above and below, so neighbourhood
+ * kernels never have to special-case the border.
+ */
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class LifeBitmap {
+public:
+  LifeBitmap();
+
+  /**
+   * Resizes the bitmap to rows x cols and clears every cell.
+   * Storage is reused when the new board fits in the old one.
+   */
+  void resize(int rows, int cols);
+
+  /**
+   * Clears every cell without changing the dimensions.
+   */
+  void clear();
+
+  int numRows() const { return rows; }
+  int numCols() const { return cols; }
+
+  /**
+   * Number of 64-bit words holding the cells of one row.
+   */
+  int wordsPerRow() const { return words; }
+
+  /**
+   * Mask of the bits in the last word of a row that are real cells.
+   * Kernels must clear the remaining bits so they never come alive.
+   */
+  uint64_t lastWordMask() const { return lastMask; }
+
+  bool get(int row, int col) const {
+    return (this->row(row)[col >> 6] >> (col & 63)) & 1;
+  }
+
+  void set(int row, int col, bool alive) {
+    uint64_t bit = uint64_t(1) << (col & 63);
+    if (alive) {
+      this->row(row)[col >> 6] |= bit;
+    } else {
+      this->row(row)[col >> 6] &= ~bit;
+    }
+  }
+
+  /**
+   * Returns the first word of the given row.  Rows -1 and numRows()
+   * are valid all-zero padding rows, and word -1 and wordsPerRow() of
+   * every row are valid all-zero padding words.
+   */
+  uint64_t *row(int row) { return &bits[(row + 1) * stride + 1]; }
+  const uint64_t *row(int row) const { return &bits[(row + 1) * stride + 1]; }
+
+  /**
+   * Exchanges contents with another bitmap in constant time.
+   */
+  void swap(LifeBitmap &other);
+
+  bool operator==(const LifeBitmap &other) const;
+  bool operator!=(const LifeBitmap &other) const { return !(*this == other); }
+
+private:
+  int rows;
+  int cols;
+  int words;
+  int stride;
+  uint64_t lastMask;
+  std::vector<uint64_t> bits;
+};
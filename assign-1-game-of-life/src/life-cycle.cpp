@@ -0,0 +1,51 @@
+/**
+ * File: life-cycle.cpp
+ * --------------------
+ * Implements the generation-hash cycle detector.  The ring holds the
+ * hashes of the last maxPeriod + 1 generations and lastSeen maps each
+ * of them to the latest generation it occurred in, so a repeat is found
+ * with one lookup and the oldest entry is evicted with another.
+ */
+
+#include "life-cycle.h"
+
+#include <algorithm> // for max
+using namespace std;
+
+LifeCycleDetector::LifeCycleDetector(int maxPeriod)
+    : maxPeriod(max(maxPeriod, 1)), generation(0), period(0), cycleStart(0) {
+  ring.resize(this->maxPeriod + 1);
+  reset(0);
+}
+
+void LifeCycleDetector::reset(uint64_t hash) {
+  generation = 0;
+  period = 0;
+  cycleStart = 0;
+  lastSeen.clear();
+  ring[0] = hash;
+  lastSeen[hash] = 0;
+}
+
+bool LifeCycleDetector::record(uint64_t hash) {
+  generation++;
+  if (generation > uint64_t(maxPeriod)) {
+    // the generation about to be overwritten falls out of the window
+    uint64_t expired = generation - ring.size();
+    uint64_t expiredHash = ring[expired % ring.size()];
+    auto found = lastSeen.find(expiredHash);
+    if (found != lastSeen.end() && found->second == expired) {
+      lastSeen.erase(found);
+    }
+  }
+  ring[generation % ring.size()] = hash;
+
+  auto found = lastSeen.find(hash);
+  bool repeated = found != lastSeen.end();
+  if (repeated && period == 0) {
+    period = int(generation - found->second);
+    cycleStart = found->second;
+  }
+  lastSeen[hash] = generation;
+  return repeated;
+}
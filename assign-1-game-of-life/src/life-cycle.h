@@ -0,0 +1,71 @@
+/**
+ * File: life-cycle.h
+ * ------------------
+ * Defines a detector for boards that have fallen into a cycle, such as
+ * blinkers and other period-k oscillators, which never satisfy the
+ * generation-to-generation stability check.
+ *
+ * Generations are identified by a 64-bit Zobrist hash of their live cells:
+ * the XOR of lifeCellKey (see life-engine.h) over every live cell.
+ * Flipping a cell flips its key in or out, so engines keep the hash
+ * current in O(1) per changed cell.  Ages are deliberately left out,
+ * since an oscillator's cells keep aging.
+ */
+
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class LifeCycleDetector {
+public:
+  /**
+   * Builds a detector that recognizes cycles of period up to maxPeriod.
+   * Memory is proportional to maxPeriod.
+   */
+  explicit LifeCycleDetector(int maxPeriod = 64);
+
+  /**
+   * Forgets all history and records hash as generation 0.
+   */
+  void reset(uint64_t hash);
+
+  /**
+   * Records the hash of the next generation and returns true if that
+   * generation repeats one of the last maxPeriod generations.  Runs in
+   * constant expected time.
+   */
+  bool record(uint64_t hash);
+
+  /**
+   * Returns true once a cycle has been found.
+   */
+  bool hasCycle() const { return period > 0; }
+
+  /**
+   * Returns the period of the cycle found, or 0 if none has been found.
+   * A still life has period 1.
+   */
+  int getPeriod() const { return period; }
+
+  /**
+   * Returns the first generation of the cycle found, counting the
+   * generation passed to reset as 0.
+   */
+  uint64_t getCycleStart() const { return cycleStart; }
+
+  /**
+   * Returns the number of generations recorded since reset.
+   */
+  uint64_t getGeneration() const { return generation; }
+
+  int getMaxPeriod() const { return maxPeriod; }
+
+private:
+  int maxPeriod;
+  uint64_t generation;
+  int period;
+  uint64_t cycleStart;
+  std::vector<uint64_t> ring; // hash of generation g is ring[g % size]
+  std::unordered_map<uint64_t, uint64_t> lastSeen; // hash -> generation
+};
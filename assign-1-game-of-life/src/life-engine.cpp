@@ -0,0 +1,103 @@
+/**
+ * File: life-engine.cpp
+ * ---------------------
+ * Implements the pieces of LifeEngine shared by every engine and
+ * the factory that builds engines by name.
+ */
+
+#include "life-engine.h"
+
+#include "life-constants.h" // for kMaxAge
+#include "life-hashlife.h"  // for HashLifeEngine
+#include "life-packed.h"    // for PackedLifeEngine
+#include "life-parallel.h"  // for ParallelLifeEngine
+#include "life-sparse.h"    // for SparseLifeEngine
+using namespace std;
+
+LifeEngine::LifeEngine() : defaultGenerator(random_device()()) {
+  birthAge = [this] {
+    return uniform_int_distribution<int>(1, kMaxAge)(defaultGenerator);
+  };
+}
+
+bool LifeEngine::getBounds(int &top, int &left, int &bottom,
+                           int &right) const {
+  top = 0;
+  left = 0;
+  bottom = numRows() - 1;
+  right = numCols() - 1;
+  return numRows() > 0 && numCols() > 0;
+}
+
+uint64_t LifeEngine::getLiveHash() const {
+  uint64_t hash = 0;
+  int top, left, bottom, right;
+  if (getBounds(top, left, bottom, right)) {
+    for (int row = top; row <= bottom; row++) {
+      for (int col = left; col <= right; col++) {
+        if (getAge(row, col) > 0) {
+          hash ^= lifeCellKey(row, col);
+        }
+      }
+    }
+  }
+  return hash;
+}
+
+bool LifeEngine::setRule(const LifeRule &rule, string &error) {
+  if (rule.getStates() != 2) {
+    error = "the " + getName() + " engine only runs two-state rules, not " +
+            rule.toString();
+    return false;
+  }
+  if (rule.getBirthMask() & 1) {
+    error = "the " + getName() + " engine cannot run " + rule.toString() +
+            ", which brings empty space to life";
+    return false;
+  }
+  this->rule = rule;
+  ruleChanged();
+  return true;
+}
+
+void LifeEngine::setBirthAgeSource(const function<int()> &source) {
+  birthAge = source;
+}
+
+static uint64_t mix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+int lifeBirthAge(uint64_t seed, uint64_t generation, int row, int col) {
+  uint64_t cell = (uint64_t(uint32_t(row)) << 32) | uint32_t(col);
+  uint64_t bits = mix64(mix64(seed ^ generation) ^ cell);
+  return 1 + int(bits % kMaxAge);
+}
+
+uint64_t lifeCellKey(int row, int col) {
+  uint64_t cell = (uint64_t(uint32_t(row)) << 32) | uint32_t(col);
+  return mix64(cell ^ 0x5A17E0B7C3D2F1A9ULL);
+}
+
+unique_ptr<LifeEngine> createLifeEngine(const string &name) {
+  if (name == "packed") {
+    return unique_ptr<LifeEngine>(new PackedLifeEngine());
+  }
+  if (name == "parallel") {
+    return unique_ptr<LifeEngine>(new ParallelLifeEngine());
+  }
+  if (name == "hashlife") {
+    return unique_ptr<LifeEngine>(new HashLifeEngine());
+  }
+  if (name == "sparse") {
+    return unique_ptr<LifeEngine>(new SparseLifeEngine());
+  }
+  return nullptr;
+}
+
+vector<string> getLifeEngineNames() {
+  return {"packed", "parallel", "hashlife", "sparse"};
+}
@@ -0,0 +1,151 @@
+/**
+ * File: life-engine.h
+ * -------------------
+ * Defines the interface shared by the alternative Game of Life
+ * stepping engines, along with a factory that builds one by name so
+ * the engine can be chosen at runtime.  Engines only depend on the
+ * standard library, so they can also be driven without any graphics.
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "life-rule.h"
+
+class LifeEngine {
+public:
+  LifeEngine();
+  virtual ~LifeEngine() {}
+
+  /**
+   * Returns the name the engine is registered under in createLifeEngine.
+   */
+  virtual std::string getName() const = 0;
+
+  /**
+   * Resizes the board to rows x cols and kills every cell.
+   */
+  virtual void setDimensions(int rows, int cols) = 0;
+
+  virtual int numRows() const = 0;
+  virtual int numCols() const = 0;
+
+  /**
+   * Returns the age of the cell at (row, col), 0 meaning dead.
+   * Ages are capped at kMaxAge.
+   */
+  virtual int getAge(int row, int col) const = 0;
+
+  /**
+   * Sets the age of the cell at (row, col), 0 meaning dead.
+   */
+  virtual void setAge(int row, int col, int age) = 0;
+
+  /**
+   * Returns true if cells may live outside the rows x cols board, in
+   * which case getAge and setAge accept any coordinates and the board
+   * dimensions only describe the window being displayed.
+   */
+  virtual bool isUnbounded() const { return false; }
+
+  /**
+   * Stores the smallest rectangle holding every live cell and returns
+   * true, or returns false if nothing is alive.  Bounded engines report
+   * the whole board.
+   */
+  virtual bool getBounds(int &top, int &left, int &bottom, int &right) const;
+
+  /**
+   * Switches to the given rule for every later generation.  Engines run
+   * any two-state rule under which empty space stays empty, that is any
+   * rule without B0; for any other rule this returns false and explains
+   * why in error.
+   */
+  bool setRule(const LifeRule &rule, std::string &error);
+
+  /**
+   * Returns the rule evolve applies, B3/S23 unless setRule changed it.
+   */
+  const LifeRule &getRule() const { return rule; }
+
+  /**
+   * Advances the board by one generation using the current rule.
+   */
+  virtual void evolve() = 0;
+
+  /**
+   * Returns true if the last call to evolve left the board stable, using
+   * the same criterion as checkStable in life.cpp: no cell died and every
+   * change in age was an increase of exactly one.
+   */
+  virtual bool isStable() const = 0;
+
+  /**
+   * Returns the Zobrist hash of the live cells, the XOR of lifeCellKey
+   * over every live cell, for use with LifeCycleDetector.  The default
+   * scans the bounds; engines override it with a hash they keep current
+   * as cells are born and die.
+   */
+  virtual uint64_t getLiveHash() const;
+
+  /**
+   * Replaces the source of ages for newly born cells.  Births are drawn
+   * in row-major order, so passing the same generator the classic
+   * evolution uses reproduces its generations exactly.
+   */
+  void setBirthAgeSource(const std::function<int()> &source);
+
+protected:
+  int nextBirthAge() { return birthAge(); }
+
+  /**
+   * Called by setRule once the new rule is in place, for engines that
+   * compile the rule or memoize results computed under the old one.
+   */
+  virtual void ruleChanged() {}
+
+private:
+  LifeRule rule;
+  std::function<int()> birthAge;
+  std::minstd_rand defaultGenerator;
+
+  LifeEngine(const LifeEngine &original);
+  void operator=(const LifeEngine &rhs) const;
+};
+
+/**
+ * Function: lifeBirthAge
+ * ----------------------
+ * Returns a birth age between 1 and kMaxAge computed purely from the
+ * seed, the generation being born into and the cell's coordinates.
+ * Engines that evolve the board in any order use it to stay deterministic.
+ */
+int lifeBirthAge(uint64_t seed, uint64_t generation, int row, int col);
+
+/**
+ * Function: lifeCellKey
+ * ---------------------
+ * Returns the Zobrist key of the cell at (row, col).  Keys are derived
+ * from the coordinates, so no table is needed and any plane size works.
+ */
+uint64_t lifeCellKey(int row, int col);
+
+/**
+ * Function: createLifeEngine
+ * --------------------------
+ * Builds the engine registered under the given name, or returns nullptr
+ * if no engine has that name.
+ */
+std::unique_ptr<LifeEngine> createLifeEngine(const std::string &name);
+
+/**
+ * Function: getLifeEngineNames
+ * ----------------------------
+ * Returns the names accepted by createLifeEngine.
+ */
+std::vector<std::string> getLifeEngineNames();
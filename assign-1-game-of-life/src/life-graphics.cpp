@@ -24,7 +24,9 @@ using namespace std;
 const string LifeDisplay::kDefaultWindowTitle("Game of Life");
 const double kWindowPadding = 5; // Margin from border of window to content area
 
-LifeDisplay::LifeDisplay() : window(kDisplayWidth, kDisplayHeight) {
+LifeDisplay::LifeDisplay() : window(kDisplayWidth, kDisplayHeight),
+                             viewportRow(0), viewportCol(0),
+                             renderMode(OVAL_CELLS), raster(nullptr) {
     initializeColors();
     window.setVisible(true);
     window.setWindowTitle(kDefaultWindowTitle);
@@ -53,6 +55,22 @@ void LifeDisplay::fillCellGrid() {
     });
 }
 
+void LifeDisplay::createRaster() {
+    cells.clear();
+    raster = new GImage(numColumns, numRows);
+    GThread::runOnQtGuiThread([this] {
+        for (int r = 0; r < numRows; ++r) {
+            for (int c = 0; c < numColumns; ++c) {
+                raster->setPixel(c, r, palette[0]);
+            }
+        }
+    });
+    // one pixel per cell, stretched over the same area the ovals would cover
+    raster->setLocation(upperLeftX + 1, upperLeftY + 1);
+    raster->setSize(numColumns * cellDiameter - 1, numRows * cellDiameter - 1);
+    window.add(raster); // ownership of memory has been transferred over to window.
+}
+
 void LifeDisplay::setDimensions(int numRows, int numColumns) {
     if (numRows <= 0 || numColumns <= 0) {
         error("LifeDisplay::setDimensions number of rows and columns must both be positive!");
@@ -60,10 +78,17 @@ void LifeDisplay::setDimensions(int numRows, int numColumns) {
     
     this->numRows = numRows;
     this->numColumns = numColumns;
+    viewportRow = 0;
+    viewportCol = 0;
     ages.resize(numRows, numColumns);
     computeGeometry();
     window.clear();
-    fillCellGrid();
+    raster = nullptr;
+    if (renderMode == PIXEL_BUFFER) {
+        createRaster();
+    } else {
+        fillCellGrid();
+    }
 
     window.setColor("White");
     window.fillRect(0, 0, kDisplayWidth, kDisplayHeight);
@@ -91,14 +116,60 @@ void LifeDisplay::drawCellAt(int row, int column, int age) {
     }
     
     age = min(age, kMaxAge);
-    if (age == 0) {
+    paintCell(row, column, age);
+    ages[row][column] = age;
+}
+
+void LifeDisplay::paintCell(int row, int column, int age) {
+    if (raster) {
+        raster->setPixel(column, row, palette[age]);
+    } else if (age == 0) {
         cells[row][column]->setVisible(false);
     } else {
         cells[row][column]->setColor(colors[age]);
         cells[row][column]->setFillColor(colors[age]);
         cells[row][column]->setVisible(true);
     }
-    ages[row][column] = age;
+}
+
+void LifeDisplay::drawGeneration(const function<int(int, int)>& ageAt) {
+    pendingUpdates.clear();
+    for (int r = 0; r < numRows; ++r) {
+        for (int c = 0; c < numColumns; ++c) {
+            int age = ageAt(r, c);
+            if (age < 0) {
+                error(string(__FUNCTION__) + " was given a negative age for " +
+                      "location (" + integerToString(r) + ", " + integerToString(c) + ").");
+            }
+            age = min(age, kMaxAge);
+            if (age != ages[r][c]) {
+                ages[r][c] = age;
+                pendingUpdates.push_back({r, c, age});
+            }
+        }
+    }
+    if (pendingUpdates.empty()) {
+        return;
+    }
+    GThread::runOnQtGuiThread([this] {
+        for (const CellUpdate& update : pendingUpdates) {
+            paintCell(update.row, update.column, update.age);
+        }
+    });
+}
+
+void LifeDisplay::setViewportOrigin(int row, int col) {
+    viewportRow = row;
+    viewportCol = col;
+}
+
+void LifeDisplay::followRegion(int top, int left, int bottom, int right) {
+    bool inView = top >= viewportRow && bottom < viewportRow + numRows &&
+                  left >= viewportCol && right < viewportCol + numColumns;
+    if (!inView) {
+        setViewportOrigin(top + (bottom - top) / 2 - numRows / 2,
+                          left + (right - left) / 2 - numColumns / 2);
+    }
 }
 
 int LifeDisplay::scalePrimaryColor(int baseContribution, int age) const {
@@ -109,6 +180,7 @@ int LifeDisplay::scalePrimaryColor(int baseContribution, int age) const {
 
 void LifeDisplay::initializeColors() {
     colors.add("White"); // colors[0] is used for age 0, and is always white
+    palette.add(static_cast<int>(0xFFFFFFFFu));
     int baseColor[] = {
         randomInteger(0, 192), randomInteger(0, 192), randomInteger(0, 192)
     };
@@ -116,11 +188,14 @@ void LifeDisplay::initializeColors() {
     for (int age = 1; age <= kMaxAge; age++) {
         ostringstream oss;
         oss << "#";
+        unsigned int argb = 0xFF; // opaque alpha, then red, green and blue
         for (int primary = 0; primary < 3; primary++) {
             int contribution = scalePrimaryColor(baseColor[primary], age);
             oss << setw(2) << setfill('0') << hex << contribution;
+            argb = (argb << 8) | contribution;
         }
         colors.add(oss.str());
+        palette.add(static_cast<int>(argb));
     }
 }
 
@@ -6,13 +6,23 @@
  */
 
 #pragma once
-#include <string>    // for std::string
-#include "gwindow.h" // for GWindow
-#include "vector.h"  // for Vector
-#include "grid.h"    // for Grid
+#include <functional> // for std::function
+#include <string>     // for std::string
+#include <vector>     // for std::vector
+#include "gwindow.h"  // for GWindow
+#include "vector.h"   // for Vector
+#include "grid.h"     // for Grid
 
 class LifeDisplay {
 public:
+/**
+ * How cells are put on screen.  OVAL_CELLS gives every cell its own GOval,
+ * which looks best on small boards.  PIXEL_BUFFER keeps one GImage with a
+ * pixel per cell, scaled up to fill the board, so setup creates a single
+ * object and a frame costs at most one pixel write per cell plus one blit.
+ */
+    enum RenderMode { OVAL_CELLS, PIXEL_BUFFER };
+
 /**
  * Constructs a Life window and makes it visible.
  */
@@ -28,6 +38,13 @@ public:
  */
     void setTitle(const std::string& title);
     
+/**
+ * Selects how the next call to setDimensions sets up the board.
+ * The default is OVAL_CELLS.
+ */
+    void setRenderMode(RenderMode mode) { renderMode = mode; }
+    RenderMode getRenderMode() const { return renderMode; }
+
 /**
  * This will erase the graphics window completely and draw a black
  * border around the simulation rectangle which is centered in the
@@ -56,6 +73,33 @@ public:
   */
     void drawCellAt(int row, int column, int age);
 
+ /**
+  * Draws a whole generation, asking ageAt for the age of every cell of the
+  * display (row and column relative to the viewport origin).  The ages are
+  * compared with what is already on screen and only the cells that changed
+  * are sent to the GUI thread, all in one batch, so the cost of updating
+  * the window follows the number of changes rather than the board size.
+  * Like drawCellAt, it does not repaint the window.
+  */
+    void drawGeneration(const std::function<int(int row, int column)>& ageAt);
+
+ /**
+  * Places the upper-left corner of the display at the given location of the
+  * world, so that drawCellAt(0, 0, age) shows world cell (row, col).  This is
+  * only meaningful for worlds larger than the display, such as the unbounded
+  * plane of the sparse engine.  setDimensions resets the origin to (0, 0).
+  */
+    void setViewportOrigin(int row, int col);
+    int getViewportRow() const { return viewportRow; }
+    int getViewportCol() const { return viewportCol; }
+
+ /**
+  * Keeps the given world rectangle in view.  If any part of it lies outside
+  * the viewport, the viewport is recentred on the middle of the rectangle;
+  * otherwise it is left alone so the picture does not jitter every generation.
+  */
+    void followRegion(int top, int left, int bottom, int right);
+
  /**
   * Repaints the graphics window.
   */
@@ -78,13 +122,23 @@ private:
     GWindow window;
     int numRows;
     int numColumns;
+    int viewportRow;
+    int viewportCol;
     double upperLeftX;
     double upperLeftY;
     double cellDiameter;
     Vector<std::string> colors;
+    Vector<int> palette; // ARGB of each age, for the pixel buffer
+    RenderMode renderMode;
+    GImage* raster;      // the pixel buffer, owned by the window
     std::string windowTitle;
     Grid<int> ages;
     Grid<GOval*> cells; // to avoid redrawing duplicate cells
+
+    struct CellUpdate {
+        int row, column, age;
+    };
+    std::vector<CellUpdate> pendingUpdates; // kept to reuse its capacity
     
     static const std::string kDefaultWindowTitle;
     static const int kDisplayWidth = 10 * 72; // 10 inches
@@ -92,6 +146,8 @@ private:
     
     void initializeColors();
     void fillCellGrid();
+    void createRaster();
+    void paintCell(int row, int column, int age);
     int scalePrimaryColor(int baseContribution, int age) const;
     void computeGeometry();
     bool coordinateInRange(int row, int column) const;
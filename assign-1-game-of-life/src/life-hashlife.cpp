@@ -0,0 +1,411 @@
+/**
+ * File: life-hashlife.cpp
+ * -----------------------
+ * Implements the HashLife engine.  A node of level k covers a square of
+ * 2^k cells; its successor is the centred square of level k-1 advanced
+ * by 2^step generations (step <= k-2), computed from nine overlapping
+ * subsquares and memoized on the node.  The root is kept centred on the
+ * origin of the plane.
+ */
+
+#include "life-hashlife.h"
+
+#include <algorithm>
+#include <utility>
+using namespace std;
+
+static const int kMinRootLevel = 3;
+static const size_t kDefaultNodeLimit = size_t(1) << 22;
+
+size_t HashLifeEngine::NodeKeyHash::operator()(const NodeKey &key) const {
+  uint64_t h = reinterpret_cast<uintptr_t>(key.nw);
+  h = h * 0x9E3779B97F4A7C15ULL + reinterpret_cast<uintptr_t>(key.ne);
+  h = h * 0x9E3779B97F4A7C15ULL + reinterpret_cast<uintptr_t>(key.sw);
+  h = h * 0x9E3779B97F4A7C15ULL + reinterpret_cast<uintptr_t>(key.se);
+  return size_t(h ^ (h >> 29));
+}
+
+HashLifeEngine::HashLifeEngine()
+    : rows(0), cols(0), generation(0), stable(false),
+      nodeLimit(kDefaultNodeLimit) {
+  reset();
+}
+
+void HashLifeEngine::reset() {
+  nodes.clear();
+  table.clear();
+  emptyNodes.clear();
+  deadLeaf = newLeaf(0);
+  liveLeaf = newLeaf(1);
+  root = empty(kMinRootLevel);
+}
+
+void HashLifeEngine::setDimensions(int rows, int cols) {
+  this->rows = rows;
+  this->cols = cols;
+  generation = 0;
+  stable = false;
+  reset();
+}
+
+/*
+ * Memoized successors were computed under the old rule, so they are
+ * forgotten; the canonical nodes themselves stay valid.
+ */
+void HashLifeEngine::ruleChanged() {
+  for (Node &node : nodes) {
+    node.result = nullptr;
+    node.resultStep = -1;
+  }
+}
+
+HashLifeEngine::Node *HashLifeEngine::newLeaf(uint64_t population) {
+  Node leaf = {nullptr, nullptr, nullptr, nullptr, nullptr, population, 0, -1};
+  nodes.push_back(leaf);
+  return &nodes.back();
+}
+
+HashLifeEngine::Node *HashLifeEngine::join(Node *nw, Node *ne, Node *sw,
+                                           Node *se) {
+  NodeKey key = {nw, ne, sw, se};
+  auto found = table.find(key);
+  if (found != table.end()) {
+    return found->second;
+  }
+  uint64_t population =
+      nw->population + ne->population + sw->population + se->population;
+  Node node = {nw, ne, sw, se, nullptr, population, nw->level + 1, -1};
+  nodes.push_back(node);
+  table[key] = &nodes.back();
+  return &nodes.back();
+}
+
+HashLifeEngine::Node *HashLifeEngine::empty(int level) {
+  while ((int)emptyNodes.size() <= level) {
+    if (emptyNodes.empty()) {
+      emptyNodes.push_back(deadLeaf);
+    } else {
+      Node *smaller = emptyNodes.back();
+      emptyNodes.push_back(join(smaller, smaller, smaller, smaller));
+    }
+  }
+  return emptyNodes[level];
+}
+
+/*
+ * Surrounds a node with an empty border, doubling its side while keeping
+ * the same centre.
+ */
+HashLifeEngine::Node *HashLifeEngine::expand(Node *node) {
+  Node *border = empty(node->level - 1);
+  return join(join(border, border, border, node->nw),
+              join(border, border, node->ne, border),
+              join(border, node->sw, border, border),
+              join(node->se, border, border, border));
+}
+
+HashLifeEngine::Node *HashLifeEngine::centre(Node *node) {
+  return join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+HashLifeEngine::Node *HashLifeEngine::centreHorizontal(Node *west,
+                                                       Node *east) {
+  return join(west->ne, east->nw, west->se, east->sw);
+}
+
+HashLifeEngine::Node *HashLifeEngine::centreVertical(Node *north,
+                                                     Node *south) {
+  return join(north->sw, north->se, south->nw, south->ne);
+}
+
+/*
+ * Advances the centre 2x2 cells of a 4x4 node by one generation.
+ */
+HashLifeEngine::Node *HashLifeEngine::evolveBase(Node *node) {
+  int cells[4][4];
+  Node *quadrants[2][2] = {{node->nw, node->ne}, {node->sw, node->se}};
+  for (int qy = 0; qy < 2; qy++) {
+    for (int qx = 0; qx < 2; qx++) {
+      Node *q = quadrants[qy][qx];
+      cells[2 * qy][2 * qx] = (int)q->nw->population;
+      cells[2 * qy][2 * qx + 1] = (int)q->ne->population;
+      cells[2 * qy + 1][2 * qx] = (int)q->sw->population;
+      cells[2 * qy + 1][2 * qx + 1] = (int)q->se->population;
+    }
+  }
+  const unsigned char *table = getRule().getTable();
+  Node *next[2][2];
+  for (int y = 1; y <= 2; y++) {
+    for (int x = 1; x <= 2; x++) {
+      int neighbourhood = 0;
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          neighbourhood |= cells[y + dy][x + dx] << (3 * (dy + 1) + dx + 1);
+        }
+      }
+      next[y - 1][x - 1] = table[neighbourhood] ? liveLeaf : deadLeaf;
+    }
+  }
+  return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+HashLifeEngine::Node *HashLifeEngine::successor(Node *node, int step) {
+  if (node->population == 0) {
+    return empty(node->level - 1);
+  }
+  if (node->result != nullptr && node->resultStep == step) {
+    return node->result;
+  }
+
+  Node *result;
+  if (node->level == 2) {
+    result = evolveBase(node);
+  } else {
+    int level = node->level;
+    Node *sub[3][3] = {
+        {node->nw, centreHorizontal(node->nw, node->ne), node->ne},
+        {centreVertical(node->nw, node->sw), centre(node),
+         centreVertical(node->ne, node->se)},
+        {node->sw, centreHorizontal(node->sw, node->se), node->se}};
+
+    // at full speed each half of the jump advances 2^(level-3)
+    // generations; slower jumps spend the whole step in the second half
+    bool fullSpeed = step == level - 2;
+    int secondStep = fullSpeed ? level - 3 : step;
+    Node *part[3][3];
+    for (int y = 0; y < 3; y++) {
+      for (int x = 0; x < 3; x++) {
+        part[y][x] = fullSpeed ? successor(sub[y][x], level - 3)
+                               : centre(sub[y][x]);
+      }
+    }
+    result = join(successor(join(part[0][0], part[0][1], part[1][0],
+                                 part[1][1]),
+                            secondStep),
+                  successor(join(part[0][1], part[0][2], part[1][1],
+                                 part[1][2]),
+                            secondStep),
+                  successor(join(part[1][0], part[1][1], part[2][0],
+                                 part[2][1]),
+                            secondStep),
+                  successor(join(part[1][1], part[1][2], part[2][1],
+                                 part[2][2]),
+                            secondStep));
+  }
+  node->result = result;
+  node->resultStep = step;
+  return result;
+}
+
+/*
+ * Returns true if every live cell of the node lies in its central
+ * quarter, so it cannot escape the centre during a maximal jump.
+ */
+bool HashLifeEngine::fitsInCentre(const Node *node) const {
+  return node->nw->population == node->nw->se->se->population &&
+         node->ne->population == node->ne->sw->sw->population &&
+         node->sw->population == node->sw->ne->ne->population &&
+         node->se->population == node->se->nw->nw->population;
+}
+
+void HashLifeEngine::jump(int exponent) {
+  Node *before = root;
+  while (root->level < exponent + 2 || !fitsInCentre(root)) {
+    root = expand(root);
+  }
+  // keep one extra ring so a full-speed jump has room to grow into
+  root = successor(expand(root), exponent);
+  generation += uint64_t(1) << exponent;
+  stable = samePattern(before, root);
+  if (nodes.size() > nodeLimit) {
+    collectGarbage();
+  }
+}
+
+void HashLifeEngine::stepBy(uint64_t generations) {
+  bool allStable = true;
+  for (int exponent = 0; generations != 0; exponent++, generations >>= 1) {
+    if (generations & 1) {
+      jump(exponent);
+      allStable = allStable && stable;
+    }
+  }
+  stable = allStable;
+}
+
+void HashLifeEngine::advanceTo(uint64_t target) {
+  if (target > generation) {
+    stepBy(target - generation);
+  }
+}
+
+uint64_t HashLifeEngine::getPopulation() const { return root->population; }
+
+bool HashLifeEngine::samePattern(Node *one, Node *two) {
+  while (one->level < two->level) {
+    one = expand(one);
+  }
+  while (two->level < one->level) {
+    two = expand(two);
+  }
+  return one == two;
+}
+
+HashLifeEngine::Node *HashLifeEngine::setCell(Node *node, int64_t x, int64_t y,
+                                              bool alive) {
+  if (node->level == 0) {
+    return alive ? liveLeaf : deadLeaf;
+  }
+  int64_t half = int64_t(1) << (node->level - 1);
+  Node *nw = node->nw, *ne = node->ne, *sw = node->sw, *se = node->se;
+  if (y < half) {
+    if (x < half) {
+      nw = setCell(nw, x, y, alive);
+    } else {
+      ne = setCell(ne, x - half, y, alive);
+    }
+  } else {
+    if (x < half) {
+      sw = setCell(sw, x, y - half, alive);
+    } else {
+      se = setCell(se, x - half, y - half, alive);
+    }
+  }
+  return join(nw, ne, sw, se);
+}
+
+bool HashLifeEngine::getCell(const Node *node, int64_t x, int64_t y) const {
+  while (node->level > 0) {
+    if (node->population == 0) {
+      return false;
+    }
+    int64_t half = int64_t(1) << (node->level - 1);
+    if (y < half) {
+      node = x < half ? node->nw : node->ne;
+    } else {
+      node = x < half ? node->sw : node->se;
+      y -= half;
+    }
+    if (x >= half) {
+      x -= half;
+    }
+  }
+  return node->population != 0;
+}
+
+uint64_t HashLifeEngine::hashCells(const Node *node, int64_t top,
+                                   int64_t left) const {
+  if (node->population == 0) {
+    return 0;
+  }
+  if (node->level == 0) {
+    return lifeCellKey(int(top), int(left));
+  }
+  int64_t half = int64_t(1) << (node->level - 1);
+  return hashCells(node->nw, top, left) ^
+         hashCells(node->ne, top, left + half) ^
+         hashCells(node->sw, top + half, left) ^
+         hashCells(node->se, top + half, left + half);
+}
+
+uint64_t HashLifeEngine::getLiveHash() const {
+  int64_t half = int64_t(1) << (root->level - 1);
+  return hashCells(root, -half, -half);
+}
+
+/*
+ * Widens bounds, {top, left, bottom, right}, to take in every live cell
+ * of the node whose upper-left cell is (top, left).  A node already
+ * inside the bounds cannot widen them, so only the edges of the pattern
+ * are walked down to single cells.
+ */
+void HashLifeEngine::boundCells(const Node *node, int64_t top, int64_t left,
+                                int64_t bounds[4]) const {
+  if (node->population == 0) {
+    return;
+  }
+  int64_t size = int64_t(1) << node->level;
+  if (top >= bounds[0] && left >= bounds[1] && top + size - 1 <= bounds[2] &&
+      left + size - 1 <= bounds[3]) {
+    return;
+  }
+  if (node->level == 0) {
+    bounds[0] = min(bounds[0], top);
+    bounds[1] = min(bounds[1], left);
+    bounds[2] = max(bounds[2], top);
+    bounds[3] = max(bounds[3], left);
+    return;
+  }
+  int64_t half = size / 2;
+  boundCells(node->nw, top, left, bounds);
+  boundCells(node->ne, top, left + half, bounds);
+  boundCells(node->sw, top + half, left, bounds);
+  boundCells(node->se, top + half, left + half, bounds);
+}
+
+bool HashLifeEngine::getBounds(int &top, int &left, int &bottom,
+                               int &right) const {
+  if (root->population == 0) {
+    return false;
+  }
+  int64_t half = int64_t(1) << (root->level - 1);
+  int64_t bounds[4] = {INT64_MAX, INT64_MAX, INT64_MIN, INT64_MIN};
+  boundCells(root, -half, -half, bounds);
+  top = int(bounds[0]);
+  left = int(bounds[1]);
+  bottom = int(bounds[2]);
+  right = int(bounds[3]);
+  return true;
+}
+
+int HashLifeEngine::getAge(int row, int col) const {
+  int64_t half = int64_t(1) << (root->level - 1);
+  if (row < -half || row >= half || col < -half || col >= half) {
+    return 0;
+  }
+  return getCell(root, col + half, row + half) ? 1 : 0;
+}
+
+void HashLifeEngine::setAge(int row, int col, int age) {
+  while (true) {
+    int64_t half = int64_t(1) << (root->level - 1);
+    if (row >= -half && row < half && col >= -half && col < half) {
+      root = setCell(root, col + half, row + half, age > 0);
+      return;
+    }
+    root = expand(root);
+  }
+}
+
+HashLifeEngine::Node *
+HashLifeEngine::copyNode(Node *node, unordered_map<Node *, Node *> &copied) {
+  auto found = copied.find(node);
+  if (found != copied.end()) {
+    return found->second;
+  }
+  Node *copy = join(copyNode(node->nw, copied), copyNode(node->ne, copied),
+                    copyNode(node->sw, copied), copyNode(node->se, copied));
+  copied[node] = copy;
+  return copy;
+}
+
+/*
+ * Rebuilds the node table with only the nodes reachable from the root.
+ * Memoized results are dropped along with everything else.
+ */
+void HashLifeEngine::collectGarbage() {
+  deque<Node> oldNodes;
+  oldNodes.swap(nodes);
+  Node *oldDead = deadLeaf;
+  Node *oldLive = liveLeaf;
+  Node *oldRoot = root;
+  table.clear();
+  emptyNodes.clear();
+  deadLeaf = newLeaf(0);
+  liveLeaf = newLeaf(1);
+
+  unordered_map<Node *, Node *> copied;
+  copied[oldDead] = deadLeaf;
+  copied[oldLive] = liveLeaf;
+  root = copyNode(oldRoot, copied);
+}
@@ -0,0 +1,141 @@
+/**
+ * File: life-hashlife.h
+ * ---------------------
+ * Defines a HashLife engine: the universe is a quadtree whose nodes are
+ * canonicalized in a hash-consed table, so identical regions are stored
+ * once, and the result of advancing a node is memoized on the node.
+ * Highly repetitive patterns can then be advanced 2^k generations in a
+ * single step on a plane far larger than any dense grid.
+ *
+ * The plane is unbounded: the board dimensions only choose the window
+ * that getAge and setAge address, with (0, 0) at its upper-left corner.
+ * Cells are not aged in this mode; every live cell reports age 1.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "life-engine.h"
+
+class HashLifeEngine : public LifeEngine {
+public:
+  HashLifeEngine();
+
+  std::string getName() const override { return "hashlife"; }
+  void setDimensions(int rows, int cols) override;
+  int numRows() const override { return rows; }
+  int numCols() const override { return cols; }
+  int getAge(int row, int col) const override;
+  void setAge(int row, int col, int age) override;
+  void evolve() override { stepBy(1); }
+  bool isStable() const override { return stable; }
+  bool isUnbounded() const override { return true; }
+
+  /**
+   * Both walk the quadtree, skipping empty nodes, so the cost follows the
+   * population rather than the size of the plane.
+   */
+  uint64_t getLiveHash() const override;
+  bool getBounds(int &top, int &left, int &bottom, int &right) const override;
+
+  /**
+   * Advances the universe by the given number of generations, using one
+   * memoized jump per set bit of the count.
+   */
+  void stepBy(uint64_t generations);
+
+  /**
+   * Advances the universe by 2^exponent generations in a single jump.
+   */
+  void jump(int exponent);
+
+  /**
+   * Advances the universe until getGeneration() equals target.  Targets
+   * in the past are ignored.
+   */
+  void advanceTo(uint64_t target);
+
+  /**
+   * Returns how many generations have elapsed since the last call to
+   * setDimensions.
+   */
+  uint64_t getGeneration() const { return generation; }
+
+  /**
+   * Returns the number of live cells on the whole plane.
+   */
+  uint64_t getPopulation() const;
+
+  /**
+   * Returns the number of canonical nodes currently allocated.
+   */
+  size_t getNodeCount() const { return nodes.size(); }
+
+  /**
+   * Sets how many nodes may be allocated before unreachable nodes and
+   * memoized results are discarded.
+   */
+  void setNodeLimit(size_t limit) { nodeLimit = limit; }
+
+private:
+  struct Node {
+    Node *nw, *ne, *sw, *se;
+    Node *result;      // memoized centre advanced by 2^resultStep
+    uint64_t population;
+    int level;         // node covers 2^level x 2^level cells
+    int resultStep;
+  };
+
+  struct NodeKey {
+    const Node *nw, *ne, *sw, *se;
+    bool operator==(const NodeKey &other) const {
+      return nw == other.nw && ne == other.ne && sw == other.sw &&
+             se == other.se;
+    }
+  };
+
+  struct NodeKeyHash {
+    size_t operator()(const NodeKey &key) const;
+  };
+
+  int rows;
+  int cols;
+  uint64_t generation;
+  bool stable;
+  size_t nodeLimit;
+  std::deque<Node> nodes;
+  std::unordered_map<NodeKey, Node *, NodeKeyHash> table;
+  std::vector<Node *> emptyNodes; // emptyNodes[k] is the empty node of level k
+  Node *deadLeaf;
+  Node *liveLeaf;
+  Node *root;
+
+  void reset();
+  void ruleChanged() override;
+  Node *newLeaf(uint64_t population);
+  Node *join(Node *nw, Node *ne, Node *sw, Node *se);
+  Node *empty(int level);
+  Node *expand(Node *node);
+  Node *centre(Node *node);
+  Node *centreHorizontal(Node *west, Node *east);
+  Node *centreVertical(Node *north, Node *south);
+  Node *successor(Node *node, int step);
+  Node *evolveBase(Node *node);
+  Node *setCell(Node *node, int64_t x, int64_t y, bool alive);
+  bool getCell(const Node *node, int64_t x, int64_t y) const;
+  uint64_t hashCells(const Node *node, int64_t top, int64_t left) const;
+  void boundCells(const Node *node, int64_t top, int64_t left,
+                  int64_t bounds[4]) const;
+  bool fitsInCentre(const Node *node) const;
+  bool samePattern(Node *one, Node *two);
+  Node *copyNode(Node *node, std::unordered_map<Node *, Node *> &copied);
+  void collectGarbage();
+
+  HashLifeEngine(const HashLifeEngine &original);
+  void operator=(const HashLifeEngine &rhs) const;
+};
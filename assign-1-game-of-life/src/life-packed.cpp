@@ -0,0 +1,404 @@
+/**
+ * File: life-packed.cpp
+ * ---------------------
+ * Implements the bit-packed Game of Life engine.  The neighbour count
+ * of 64 cells is computed at once as four bit-planes (count bits 1, 2,
+ * 4 and 8) by a small network of full adders.  The same kernel is
+ * instantiated over plain 64-bit words and, on x86, over 128- and
+ * 256-bit vectors; the widest one the CPU supports is picked at runtime.
+ *
+ * Conway's B3/S23 reduces to a four-operation expression of the count
+ * bits.  Any other rule runs a second kernel that looks each count up in
+ * the rule's selector words through a tree of bitwise multiplexers, so
+ * neither kernel tests the rule per cell.
+ */
+
+#include "life-packed.h"
+
+#include <algorithm> // for min, max, sort
+#include <cstring>   // for memcpy
+using namespace std;
+
+#include "life-constants.h" // for kMaxAge
+
+static const int kTileRows = 16;
+static const int kTileWords = 2; // 128 columns
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIFE_X86_KERNELS 1
+#define LIFE_INLINE inline __attribute__((always_inline))
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+#elif defined(__GNUC__)
+#define LIFE_INLINE inline __attribute__((always_inline))
+#else
+#define LIFE_INLINE inline
+#endif
+
+/*
+ * Vectors are only ever passed by reference so that the wide
+ * instantiations never cross a function boundary by value.
+ */
+template <typename Word>
+static LIFE_INLINE void loadWords(Word &w, const uint64_t *p) {
+  memcpy(&w, p, sizeof(Word));
+}
+
+template <typename Word>
+static LIFE_INLINE void fullAdd(const Word &a, const Word &b, const Word &c,
+                                Word &sum, Word &carry) {
+  Word t = a ^ b;
+  sum = t ^ c;
+  carry = (a & b) | (t & c);
+}
+
+// stores b where select is set and a elsewhere
+template <typename Word>
+static LIFE_INLINE void mux(const Word &select, const Word &a, const Word &b,
+                            Word &out) {
+  out = a ^ ((a ^ b) & select);
+}
+
+template <typename Word>
+static LIFE_INLINE void broadcast(Word &w, uint64_t value) {
+  uint64_t lanes[sizeof(Word) / sizeof(uint64_t)];
+  for (uint64_t &lane : lanes) {
+    lane = value;
+  }
+  memcpy(&w, lanes, sizeof(Word));
+}
+
+/*
+ * B3/S23: exactly three neighbours, or exactly two and alive.
+ */
+template <typename Word> struct ConwayLogic {
+  explicit ConwayLogic(const LifeRule &) {}
+
+  LIFE_INLINE void apply(const Word &bit0, const Word &bit1, const Word &bit2,
+                         const Word &bit3, const Word &alive,
+                         Word &result) const {
+    result = bit1 & ~bit2 & ~bit3 & (bit0 | alive);
+  }
+};
+
+/*
+ * Any two-state rule: each lane first picks the birth or survival
+ * outcome of every count by its own state, then the count bits narrow
+ * the nine outcomes down to one.  A count of 8 is the only one with
+ * bit 3 set.
+ */
+template <typename Word> struct MaskLogic {
+  Word birth[9];
+  Word survival[9];
+
+  explicit MaskLogic(const LifeRule &rule) {
+    const uint64_t *selectors = rule.getSelectors();
+    for (int n = 0; n <= 8; n++) {
+      broadcast(birth[n], selectors[n]);
+      broadcast(survival[n], selectors[9 + n]);
+    }
+  }
+
+  LIFE_INLINE void apply(const Word &bit0, const Word &bit1, const Word &bit2,
+                         const Word &bit3, const Word &alive,
+                         Word &result) const {
+    Word outcome[9];
+    for (int n = 0; n <= 8; n++) {
+      mux(alive, birth[n], survival[n], outcome[n]);
+    }
+    Word pairs[4];
+    for (int k = 0; k < 4; k++) {
+      mux(bit0, outcome[2 * k], outcome[2 * k + 1], pairs[k]);
+    }
+    Word quads[2];
+    for (int k = 0; k < 2; k++) {
+      mux(bit1, pairs[2 * k], pairs[2 * k + 1], quads[k]);
+    }
+    Word low;
+    mux(bit2, quads[0], quads[1], low);
+    mux(bit3, low, outcome[8], result);
+  }
+};
+
+/*
+ * Computes the next generation of the words starting at index i of a
+ * row.  West neighbours are the row shifted towards higher columns with
+ * the top bit of the previous word carried in, east neighbours the
+ * reverse.
+ */
+template <typename Word, typename Logic>
+static LIFE_INLINE void evolveWords(const uint64_t *above, const uint64_t *row,
+                                    const uint64_t *below, uint64_t *out,
+                                    int i, const Logic &logic) {
+  Word a, ap, an, x, xp, xn, b, bp, bn;
+  loadWords(a, above + i);
+  loadWords(ap, above + i - 1);
+  loadWords(an, above + i + 1);
+  loadWords(x, row + i);
+  loadWords(xp, row + i - 1);
+  loadWords(xn, row + i + 1);
+  loadWords(b, below + i);
+  loadWords(bp, below + i - 1);
+  loadWords(bn, below + i + 1);
+  Word aw = (a << 1) | (ap >> 63);
+  Word ae = (a >> 1) | (an << 63);
+  Word xw = (x << 1) | (xp >> 63);
+  Word xe = (x >> 1) | (xn << 63);
+  Word bw = (b << 1) | (bp >> 63);
+  Word be = (b >> 1) | (bn << 63);
+
+  // each row of three collapses to a two-bit sum, the middle row to two
+  Word sumA, carryA, sumB, carryB;
+  fullAdd(aw, a, ae, sumA, carryA);
+  fullAdd(bw, b, be, sumB, carryB);
+  Word sumX = xw ^ xe;
+  Word carryX = xw & xe;
+
+  Word bit0, ones;
+  fullAdd(sumA, sumB, sumX, bit0, ones);
+  Word twos, fours;
+  fullAdd(carryA, carryB, carryX, twos, fours);
+  Word bit1 = twos ^ ones;
+  Word moreFours = twos & ones;
+  Word bit2 = fours ^ moreFours;
+  Word bit3 = fours & moreFours;
+
+  Word result;
+  logic.apply(bit0, bit1, bit2, bit3, x, result);
+  memcpy(out + i, &result, sizeof(Word));
+}
+
+template <typename Word, template <typename> class Logic>
+static LIFE_INLINE int evolveSpan(const uint64_t *above, const uint64_t *row,
+                                  const uint64_t *below, uint64_t *out,
+                                  int begin, int count, const LifeRule &rule) {
+  const int lanes = sizeof(Word) / sizeof(uint64_t);
+  Logic<Word> logic(rule);
+  int i = begin;
+  for (; i + lanes <= count; i += lanes) {
+    evolveWords<Word>(above, row, below, out, i, logic);
+  }
+  return i;
+}
+
+template <template <typename> class Logic>
+static void evolveRowPortable(const uint64_t *above, const uint64_t *row,
+                              const uint64_t *below, uint64_t *out, int count,
+                              const LifeRule &rule) {
+  evolveSpan<uint64_t, Logic>(above, row, below, out, 0, count, rule);
+}
+
+#ifdef LIFE_X86_KERNELS
+template <template <typename> class Logic>
+__attribute__((target("sse2"))) static void
+evolveRowSse2(const uint64_t *above, const uint64_t *row, const uint64_t *below,
+              uint64_t *out, int count, const LifeRule &rule) {
+  int done = evolveSpan<u64x2, Logic>(above, row, below, out, 0, count, rule);
+  evolveSpan<uint64_t, Logic>(above, row, below, out, done, count, rule);
+}
+
+template <template <typename> class Logic>
+__attribute__((target("avx2"))) static void
+evolveRowAvx2(const uint64_t *above, const uint64_t *row, const uint64_t *below,
+              uint64_t *out, int count, const LifeRule &rule) {
+  int done = evolveSpan<u64x4, Logic>(above, row, below, out, 0, count, rule);
+  evolveSpan<uint64_t, Logic>(above, row, below, out, done, count, rule);
+}
+#endif
+
+PackedLifeEngine::RowKernel
+PackedLifeEngine::selectRowKernel(const LifeRule &rule, string &name) {
+  bool conway = rule.isConway();
+#ifdef LIFE_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    name = "avx2";
+    return conway ? evolveRowAvx2<ConwayLogic> : evolveRowAvx2<MaskLogic>;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    name = "sse2";
+    return conway ? evolveRowSse2<ConwayLogic> : evolveRowSse2<MaskLogic>;
+  }
+#endif
+  name = "portable";
+  return conway ? evolveRowPortable<ConwayLogic>
+                : evolveRowPortable<MaskLogic>;
+}
+
+PackedLifeEngine::PackedLifeEngine()
+    : generation(0), liveHash(0), stable(false), tileRowCount(0),
+      tileColCount(0), lastActiveCount(0) {
+  kernel = selectRowKernel(getRule(), kernelName);
+}
+
+/*
+ * Quiet tiles are only skipped because the rule would recompute them
+ * unchanged, which no longer holds under a new rule.
+ */
+void PackedLifeEngine::ruleChanged() {
+  kernel = selectRowKernel(getRule(), kernelName);
+  for (int tile = 0; tile < (int)tileChanged.size(); tile++) {
+    if (!tileChanged[tile]) {
+      tileChanged[tile] = true;
+      changedTiles.push_back(tile);
+    }
+  }
+}
+
+void PackedLifeEngine::setDimensions(int rows, int cols) {
+  current.resize(rows, cols);
+  next.resize(rows, cols);
+  ageOrigins.assign(size_t(rows) * cols, 0);
+  generation = 0;
+  liveHash = 0;
+  stable = false;
+  tileRowCount = (rows + kTileRows - 1) / kTileRows;
+  tileColCount = (current.wordsPerRow() + kTileWords - 1) / kTileWords;
+  tileChanged.assign(size_t(tileRowCount) * tileColCount, false);
+  tileActive.assign(tileChanged.size(), false);
+  changedTiles.clear();
+  activeTiles.clear();
+  lastActiveCount = 0;
+}
+
+int PackedLifeEngine::getAge(int row, int col) const {
+  if (!current.get(row, col)) {
+    return 0;
+  }
+  uint32_t age = generation - ageOrigins[size_t(row) * numCols() + col];
+  return (int)min(age, uint32_t(kMaxAge));
+}
+
+void PackedLifeEngine::setAge(int row, int col, int age) {
+  age = min(max(age, 0), kMaxAge);
+  ageOrigins[size_t(row) * numCols() + col] = generation - age;
+  if (current.get(row, col) != (age > 0)) {
+    liveHash ^= lifeCellKey(row, col);
+  }
+  current.set(row, col, age > 0);
+  markChanged(row, col / 64);
+}
+
+void PackedLifeEngine::markChanged(int row, int word) {
+  int tile = (row / kTileRows) * tileColCount + word / kTileWords;
+  if (!tileChanged[tile]) {
+    tileChanged[tile] = true;
+    changedTiles.push_back(tile);
+  }
+}
+
+/*
+ * Turns the tiles that changed last generation into the sorted list of
+ * tiles to recompute: each changed tile and its eight neighbours.  A tile
+ * left out did not change, so both planes already agree on its contents.
+ */
+void PackedLifeEngine::collectActiveTiles() {
+  for (int tile : activeTiles) {
+    tileActive[tile] = false;
+  }
+  activeTiles.clear();
+  for (int tile : changedTiles) {
+    tileChanged[tile] = false;
+    int tileRow = tile / tileColCount;
+    int tileCol = tile % tileColCount;
+    for (int r = max(tileRow - 1, 0); r <= min(tileRow + 1, tileRowCount - 1);
+         r++) {
+      for (int c = max(tileCol - 1, 0);
+           c <= min(tileCol + 1, tileColCount - 1); c++) {
+        int neighbour = r * tileColCount + c;
+        if (!tileActive[neighbour]) {
+          tileActive[neighbour] = true;
+          activeTiles.push_back(neighbour);
+        }
+      }
+    }
+  }
+  changedTiles.clear();
+  sort(activeTiles.begin(), activeTiles.end());
+}
+
+/*
+ * Recomputes the active tiles in row-major order: each band of tile rows
+ * is swept one cell row at a time, running the kernel once per stretch of
+ * adjacent active tiles.  Births therefore consume ages in the same order
+ * as the classic evolution.
+ */
+void PackedLifeEngine::evolve() {
+  collectActiveTiles();
+  lastActiveCount = (int)activeTiles.size();
+  stable = true;
+  int rows = numRows();
+  int words = current.wordsPerRow();
+  size_t band = 0;
+  while (band < activeTiles.size()) {
+    int tileRow = activeTiles[band] / tileColCount;
+    size_t bandEnd = band;
+    while (bandEnd < activeTiles.size() &&
+           activeTiles[bandEnd] / tileColCount == tileRow) {
+      bandEnd++;
+    }
+    int endRow = min((tileRow + 1) * kTileRows, rows);
+    for (int r = tileRow * kTileRows; r < endRow; r++) {
+      size_t stretch = band;
+      while (stretch < bandEnd) {
+        size_t stretchEnd = stretch + 1;
+        while (stretchEnd < bandEnd &&
+               activeTiles[stretchEnd] == activeTiles[stretchEnd - 1] + 1) {
+          stretchEnd++;
+        }
+        int firstWord = (activeTiles[stretch] % tileColCount) * kTileWords;
+        int endWord = min(
+            (activeTiles[stretchEnd - 1] % tileColCount + 1) * kTileWords,
+            words);
+        evolveSpan(r, firstWord, endWord);
+        stretch = stretchEnd;
+      }
+    }
+    band = bandEnd;
+  }
+  current.swap(next);
+  generation++;
+}
+
+/*
+ * Computes words [firstWord, endWord) of one row of the next generation,
+ * records which tiles changed, gives newborn cells their ages and folds
+ * every flipped cell into the live hash.
+ */
+void PackedLifeEngine::evolveSpan(int row, int firstWord, int endWord) {
+  const uint64_t *before = current.row(row);
+  uint64_t *after = next.row(row);
+  kernel(current.row(row - 1) + firstWord, before + firstWord,
+         current.row(row + 1) + firstWord, after + firstWord,
+         endWord - firstWord, getRule());
+  if (endWord == current.wordsPerRow()) {
+    after[endWord - 1] &= current.lastWordMask();
+  }
+
+  uint32_t *rowOrigins = &ageOrigins[size_t(row) * numCols()];
+  for (int w = firstWord; w < endWord; w++) {
+    if (before[w] == after[w]) {
+      continue;
+    }
+    markChanged(row, w);
+    if (before[w] & ~after[w]) {
+      stable = false;
+    }
+    uint64_t flipped = before[w] ^ after[w];
+    while (flipped != 0) {
+      int bit = __builtin_ctzll(flipped);
+      flipped &= flipped - 1;
+      liveHash ^= lifeCellKey(row, w * 64 + bit);
+    }
+    uint64_t births = after[w] & ~before[w];
+    while (births != 0) {
+      int bit = __builtin_ctzll(births);
+      births &= births - 1;
+      int age = min(nextBirthAge(), kMaxAge);
+      rowOrigins[w * 64 + bit] = generation + 1 - age;
+      if (age != 1) {
+        stable = false;
+      }
+    }
+  }
+}
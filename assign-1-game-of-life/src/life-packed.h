@@ -0,0 +1,93 @@
+/**
+ * File: life-packed.h
+ * -------------------
+ * Defines a Game of Life engine that stores liveness as packed 64-bit
+ * words and computes all eight neighbour counts at once with bitwise
+ * full-adder logic.
+ *
+ * The board is divided into tiles, and only tiles next to a tile that
+ * changed in the previous generation are recomputed, so sparse or mostly
+ * settled boards cost time in proportion to their activity rather than
+ * their area.  Ages are stored lazily as the generation each cell's age
+ * counts from, so survivors never need to be visited to grow older.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "life-bitmap.h"
+#include "life-engine.h"
+
+class PackedLifeEngine : public LifeEngine {
+public:
+  PackedLifeEngine();
+
+  std::string getName() const override { return "packed"; }
+  void setDimensions(int rows, int cols) override;
+  int numRows() const override { return current.numRows(); }
+  int numCols() const override { return current.numCols(); }
+  int getAge(int row, int col) const override;
+  void setAge(int row, int col, int age) override;
+  void evolve() override;
+  bool isStable() const override { return stable; }
+  uint64_t getLiveHash() const override { return liveHash; }
+
+  /**
+   * Returns the liveness plane of the current generation.
+   */
+  const LifeBitmap &getBitmap() const { return current; }
+
+  /**
+   * Returns which row kernel was selected for this machine:
+   * "avx2", "sse2" or "portable".
+   */
+  std::string getKernelName() const { return kernelName; }
+
+  /**
+   * Returns how many tiles the last call to evolve recomputed.
+   */
+  int getActiveTileCount() const { return lastActiveCount; }
+
+  /**
+   * Signature of a row kernel: computes words [0, count) of the next
+   * generation of a row from the row and its two vertical neighbours
+   * under the given rule.  Every pointer must allow reading one word
+   * before and after the range.
+   */
+  typedef void (*RowKernel)(const uint64_t *above, const uint64_t *row,
+                            const uint64_t *below, uint64_t *out, int count,
+                            const LifeRule &rule);
+
+  /**
+   * Returns the widest row kernel this CPU supports for rules like the
+   * given one and stores its name.  Conway's rule gets a kernel of its
+   * own and every other two-state rule shares one driven by the rule's
+   * selector words, so select again whenever the rule changes.
+   */
+  static RowKernel selectRowKernel(const LifeRule &rule, std::string &name);
+
+private:
+  LifeBitmap current;
+  LifeBitmap next;
+  std::vector<uint32_t> ageOrigins; // a live cell's age is generation - origin
+  uint32_t generation;
+  uint64_t liveHash;
+  bool stable;
+  RowKernel kernel;
+  std::string kernelName;
+
+  int tileRowCount;
+  int tileColCount;
+  std::vector<char> tileChanged; // changed during the latest generation
+  std::vector<int> changedTiles;
+  std::vector<char> tileActive;
+  std::vector<int> activeTiles;
+  int lastActiveCount;
+
+  void ruleChanged() override;
+  void markChanged(int row, int word);
+  void collectActiveTiles();
+  void evolveSpan(int row, int firstWord, int endWord);
+};
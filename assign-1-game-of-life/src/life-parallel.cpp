@@ -0,0 +1,132 @@
+/**
+ * File: life-parallel.cpp
+ * -----------------------
+ * Implements the multithreaded tiled Game of Life engine.
+ */
+
+#include "life-parallel.h"
+
+#include <algorithm> // for min, max
+using namespace std;
+
+#include "life-constants.h" // for kMaxAge
+
+static const int kTileRows = 64;
+static const int kTileWords = 16; // 1024 columns
+
+ParallelLifeEngine::ParallelLifeEngine(int threads)
+    : pool(new LifeThreadPool(threads)), seed(0), generation(0),
+      liveHash(0), stable(false) {
+  string kernelName;
+  kernel = PackedLifeEngine::selectRowKernel(getRule(), kernelName);
+}
+
+void ParallelLifeEngine::ruleChanged() {
+  string kernelName;
+  kernel = PackedLifeEngine::selectRowKernel(getRule(), kernelName);
+}
+
+void ParallelLifeEngine::setThreadCount(int threads) {
+  pool.reset(new LifeThreadPool(threads));
+}
+
+void ParallelLifeEngine::setDimensions(int rows, int cols) {
+  current.resize(rows, cols);
+  next.resize(rows, cols);
+  ages.assign(size_t(rows) * cols, 0);
+  generation = 0;
+  liveHash = 0;
+  stable = false;
+  buildTiles();
+}
+
+void ParallelLifeEngine::buildTiles() {
+  tiles.clear();
+  int rows = current.numRows();
+  int words = current.wordsPerRow();
+  for (int row = 0; row < rows; row += kTileRows) {
+    for (int word = 0; word < words; word += kTileWords) {
+      Tile tile = {row, min(row + kTileRows, rows), word,
+                   min(word + kTileWords, words)};
+      tiles.push_back(tile);
+    }
+  }
+  tileStable.assign(tiles.size(), true);
+  tileHash.assign(tiles.size(), 0);
+}
+
+int ParallelLifeEngine::getAge(int row, int col) const {
+  return ages[size_t(row) * numCols() + col];
+}
+
+void ParallelLifeEngine::setAge(int row, int col, int age) {
+  age = min(max(age, 0), kMaxAge);
+  ages[size_t(row) * numCols() + col] = age;
+  if (current.get(row, col) != (age > 0)) {
+    liveHash ^= lifeCellKey(row, col);
+  }
+  current.set(row, col, age > 0);
+}
+
+void ParallelLifeEngine::evolve() {
+  pool->run((int)tiles.size(), [this](int index) { evolveTile(index); });
+  current.swap(next);
+  generation++;
+  stable = all_of(tileStable.begin(), tileStable.end(),
+                  [](char tileIsStable) { return tileIsStable != 0; });
+  for (uint64_t flipped : tileHash) {
+    liveHash ^= flipped;
+  }
+}
+
+/*
+ * Computes one tile of the next generation and updates its ages.  Only
+ * this tile's words of the next plane are written; the halo words just
+ * outside it are read from the current plane.
+ */
+void ParallelLifeEngine::evolveTile(int index) {
+  const Tile &tile = tiles[index];
+  int cols = numCols();
+  int words = current.wordsPerRow();
+  int count = tile.endWord - tile.firstWord;
+  bool tileIsStable = true;
+  uint64_t flipped = 0;
+  for (int r = tile.firstRow; r < tile.endRow; r++) {
+    const uint64_t *before = current.row(r);
+    uint64_t *after = next.row(r);
+    kernel(current.row(r - 1) + tile.firstWord, before + tile.firstWord,
+           current.row(r + 1) + tile.firstWord, after + tile.firstWord, count,
+           getRule());
+    if (tile.endWord == words) {
+      after[words - 1] &= current.lastWordMask();
+    }
+
+    unsigned char *rowAges = &ages[size_t(r) * cols];
+    for (int w = tile.firstWord; w < tile.endWord; w++) {
+      uint64_t touched = before[w] | after[w];
+      while (touched != 0) {
+        int bit = __builtin_ctzll(touched);
+        touched &= touched - 1;
+        uint64_t mask = uint64_t(1) << bit;
+        int col = w * 64 + bit;
+        unsigned char &age = rowAges[col];
+        if ((before[w] ^ after[w]) & mask) {
+          flipped ^= lifeCellKey(r, col);
+        }
+        if (!(after[w] & mask)) {
+          age = 0;
+          tileIsStable = false;
+        } else if (before[w] & mask) {
+          age = min(age + 1, kMaxAge);
+        } else {
+          age = lifeBirthAge(seed, generation + 1, r, col);
+          if (age != 1) {
+            tileIsStable = false;
+          }
+        }
+      }
+    }
+  }
+  tileStable[index] = tileIsStable;
+  tileHash[index] = flipped;
+}
@@ -0,0 +1,79 @@
+/**
+ * File: life-parallel.h
+ * ---------------------
+ * Defines a multithreaded Game of Life engine.  The packed board is cut
+ * into 2D tiles that a work-stealing pool evolves concurrently, with a
+ * barrier between generations.  Each tile reads a one-cell halo from
+ * the neighbouring tiles of the previous generation, which nobody writes
+ * during the step, so tiles never need to lock one another.
+ *
+ * Birth ages come from lifeBirthAge seeded by (generation, cell) instead
+ * of the shared birth-age source, so results do not depend on how tiles
+ * are scheduled or on the thread count.
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "life-bitmap.h"
+#include "life-engine.h"
+#include "life-packed.h"     // for PackedLifeEngine::RowKernel
+#include "life-threadpool.h"
+
+class ParallelLifeEngine : public LifeEngine {
+public:
+  /**
+   * Creates an engine using the given number of threads, zero meaning
+   * one per hardware thread.
+   */
+  explicit ParallelLifeEngine(int threads = 0);
+
+  std::string getName() const override { return "parallel"; }
+  void setDimensions(int rows, int cols) override;
+  int numRows() const override { return current.numRows(); }
+  int numCols() const override { return current.numCols(); }
+  int getAge(int row, int col) const override;
+  void setAge(int row, int col, int age) override;
+  void evolve() override;
+  bool isStable() const override { return stable; }
+  uint64_t getLiveHash() const override { return liveHash; }
+
+  /**
+   * Replaces the pool with one of the given size.
+   */
+  void setThreadCount(int threads);
+  int getThreadCount() const { return pool->numThreads(); }
+
+  /**
+   * Sets the seed mixed into every birth age.
+   */
+  void setSeed(uint64_t seed) { this->seed = seed; }
+
+  const LifeBitmap &getBitmap() const { return current; }
+
+private:
+  struct Tile {
+    int firstRow, endRow;   // rows [firstRow, endRow)
+    int firstWord, endWord; // words [firstWord, endWord) of each row
+  };
+
+  LifeBitmap current;
+  LifeBitmap next;
+  std::vector<unsigned char> ages;
+  std::vector<Tile> tiles;
+  std::vector<char> tileStable;
+  std::vector<uint64_t> tileHash; // XOR of the keys each tile flipped
+  std::unique_ptr<LifeThreadPool> pool;
+  PackedLifeEngine::RowKernel kernel;
+  uint64_t seed;
+  uint64_t generation;
+  uint64_t liveHash;
+  bool stable;
+
+  void ruleChanged() override;
+  void buildTiles();
+  void evolveTile(int index);
+};
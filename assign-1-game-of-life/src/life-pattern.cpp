@@ -0,0 +1,403 @@
+/**
+ * File: life-pattern.cpp
+ * ----------------------
+ * Implements the pattern file loader.  The file is mapped into memory
+ * (read in one go on Windows) and scanned once, or twice for plaintext
+ * files whose width is only known after the last row; live cells are
+ * OR-ed straight into the bitmap's words.
+ */
+
+#include "life-pattern.h"
+
+#include <algorithm> // for min, max
+#include <cctype>    // for isdigit, isspace
+#include <climits>   // for INT_MAX
+#include <cstdint>
+using namespace std;
+
+#ifdef _WIN32
+#include <fstream>  // for ifstream
+#include <iterator> // for istreambuf_iterator
+#else
+#include <fcntl.h>    // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close
+#endif
+
+// refuse boards whose bitmap would need more than 512MB
+static const long long kMaxPatternCells = 1LL << 32;
+
+struct Cursor {
+  const char *next;
+  const char *end;
+  int line; // number of the line most recently returned by nextLine
+};
+
+// stores the next line in [begin, stop) without its terminator
+static bool nextLine(Cursor &cursor, const char *&begin, const char *&stop) {
+  if (cursor.next >= cursor.end) {
+    return false;
+  }
+  begin = cursor.next;
+  stop = begin;
+  while (stop < cursor.end && *stop != '\n') {
+    stop++;
+  }
+  cursor.next = stop < cursor.end ? stop + 1 : stop;
+  cursor.line++;
+  while (stop > begin && isspace((unsigned char)stop[-1])) {
+    stop--;
+  }
+  return true;
+}
+
+static bool fail(const string &name, int line, const string &message,
+                 string &error) {
+  error = name + ":" + to_string(line) + ": " + message;
+  return false;
+}
+
+// parses a non-negative integer filling [begin, stop), or returns -1
+static long long parseCount(const char *begin, const char *stop) {
+  while (begin < stop && isspace((unsigned char)*begin)) {
+    begin++;
+  }
+  while (stop > begin && isspace((unsigned char)stop[-1])) {
+    stop--;
+  }
+  if (begin == stop) {
+    return -1;
+  }
+  long long value = 0;
+  for (; begin < stop; begin++) {
+    if (!isdigit((unsigned char)*begin) || value > kMaxPatternCells) {
+      return -1;
+    }
+    value = value * 10 + (*begin - '0');
+  }
+  return value;
+}
+
+static bool resizeCells(LifeBitmap &cells, long long rows, long long cols,
+                        const string &name, int line, string &error) {
+  if (rows <= 0 || cols <= 0) {
+    return fail(name, line, "the pattern must have at least one row and column",
+                error);
+  }
+  if (rows > INT_MAX || cols > INT_MAX || rows * cols > kMaxPatternCells) {
+    return fail(name, line,
+                "a " + to_string(rows) + " x " + to_string(cols) +
+                    " pattern is too large to load",
+                error);
+  }
+  cells.resize(int(rows), int(cols));
+  return true;
+}
+
+// makes count cells alive starting at (row, col), a word at a time
+static void setRun(LifeBitmap &cells, int row, int col, int count) {
+  uint64_t *words = cells.row(row);
+  while (count > 0) {
+    int bit = col & 63;
+    int span = min(count, 64 - bit);
+    uint64_t run = span == 64 ? ~uint64_t(0) : ((uint64_t(1) << span) - 1);
+    words[col >> 6] |= run << bit;
+    col += span;
+    count -= span;
+  }
+}
+
+static bool isLiveMark(char ch) {
+  return ch == 'X' || ch == 'x' || ch == 'O' || ch == 'o' || ch == '*';
+}
+
+/*
+ * The res/files format: two dimension lines, then rows of '-' and 'X'.
+ * Rows shorter than the declared width are padded with dead cells.
+ */
+static bool parseClassic(Cursor &cursor, const char *begin, const char *stop,
+                         const string &name, LifeBitmap &cells,
+                         string &error) {
+  long long rows = parseCount(begin, stop);
+  int rowsLine = cursor.line;
+  if (rows < 0) {
+    return fail(name, rowsLine, "expected the number of rows", error);
+  }
+  if (!nextLine(cursor, begin, stop)) {
+    return fail(name, rowsLine, "expected the number of columns next", error);
+  }
+  long long cols = parseCount(begin, stop);
+  if (cols < 0) {
+    return fail(name, cursor.line, "expected the number of columns", error);
+  }
+  if (!resizeCells(cells, rows, cols, name, cursor.line, error)) {
+    return false;
+  }
+
+  for (int row = 0; row < rows; row++) {
+    if (!nextLine(cursor, begin, stop)) {
+      return fail(name, cursor.line,
+                  "declares " + to_string(rows) + " rows but has only " +
+                      to_string(row),
+                  error);
+    }
+    if (stop - begin > cols) {
+      return fail(name, cursor.line,
+                  "row is wider than the declared " + to_string(cols) +
+                      " columns",
+                  error);
+    }
+    uint64_t *words = cells.row(row);
+    for (const char *at = begin; at < stop; at++) {
+      if (isLiveMark(*at)) {
+        int col = int(at - begin);
+        words[col >> 6] |= uint64_t(1) << (col & 63);
+      } else if (*at != '-') {
+        return fail(name, cursor.line,
+                    string("unexpected character '") + *at + "'", error);
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * Run-length encoded patterns: a header "x = cols, y = rows[, rule = r]"
+ * and then runs of b (dead), o (alive) and $ (end of row), each optionally
+ * preceded by a count, finished by '!'.  Line breaks may appear anywhere
+ * between runs.
+ */
+static bool parseRle(Cursor &cursor, const char *begin, const char *stop,
+                     const string &name, LifeBitmap &cells, LifeRule &rule,
+                     string &error) {
+  long long cols = -1;
+  long long rows = -1;
+  int headerLine = cursor.line;
+  while (begin < stop) {
+    const char *comma = begin;
+    while (comma < stop && *comma != ',') {
+      comma++;
+    }
+    const char *equals = begin;
+    while (equals < comma && *equals != '=') {
+      equals++;
+    }
+    string key;
+    for (const char *at = begin; at < equals; at++) {
+      if (!isspace((unsigned char)*at)) {
+        key += *at;
+      }
+    }
+    if (equals == comma) {
+      return fail(name, headerLine, "expected key = value in the header",
+                  error);
+    }
+    if (key == "x") {
+      cols = parseCount(equals + 1, comma);
+    } else if (key == "y") {
+      rows = parseCount(equals + 1, comma);
+    } else if (key == "rule") {
+      string problem;
+      if (!LifeRule::parse(string(equals + 1, comma), rule, problem)) {
+        return fail(name, headerLine, problem, error);
+      }
+    } else {
+      return fail(name, headerLine, "unknown header key '" + key + "'",
+                  error);
+    }
+    begin = comma < stop ? comma + 1 : comma;
+  }
+  if (cols < 0 || rows < 0) {
+    return fail(name, headerLine, "the header needs both x and y", error);
+  }
+  if (!resizeCells(cells, rows, cols, name, headerLine, error)) {
+    return false;
+  }
+
+  int line = headerLine + 1;
+  long long row = 0;
+  long long col = 0;
+  long long count = 0;
+  bool haveCount = false;
+  for (const char *at = cursor.next; at < cursor.end; at++) {
+    char ch = *at;
+    if (isdigit((unsigned char)ch)) {
+      count = count * 10 + (ch - '0');
+      haveCount = true;
+      if (count > kMaxPatternCells) {
+        return fail(name, line, "run count is too large", error);
+      }
+      continue;
+    }
+    long long run = haveCount ? count : 1;
+    count = 0;
+    haveCount = false;
+    if (ch == '\n') {
+      line++;
+    } else if (isspace((unsigned char)ch)) {
+      // whitespace separates nothing in RLE
+    } else if (ch == '!') {
+      return true;
+    } else if (ch == '$') {
+      row += run;
+      col = 0;
+    } else if (ch == 'b' || ch == '.' || ch == 'o' ||
+               (ch >= 'A' && ch <= 'X')) {
+      if (col + run > cols || row >= rows) {
+        return fail(name, line,
+                    "pattern extends past the declared x = " + to_string(cols) +
+                        ", y = " + to_string(rows),
+                    error);
+      }
+      if (ch != 'b' && ch != '.') {
+        setRun(cells, int(row), int(col), int(run));
+      }
+      col += run;
+    } else {
+      return fail(name, line, string("unexpected character '") + ch + "'",
+                  error);
+    }
+  }
+  return true; // a missing '!' is tolerated, as most tools do
+}
+
+/*
+ * Plaintext patterns: rows of '.' and 'O' with '!' comment lines.  The
+ * first pass measures the pattern, the second fills it in.
+ */
+static bool parsePlaintext(Cursor &cursor, const char *begin,
+                           const char *stop, const string &name,
+                           LifeBitmap &cells, string &error) {
+  Cursor first = cursor;
+  const char *firstBegin = begin;
+  const char *firstStop = stop;
+  long long rows = 0;
+  long long cols = 0;
+  long long row = 0;
+  do {
+    if (begin < stop && *begin == '!') {
+      continue;
+    }
+    row++;
+    if (begin < stop) {
+      rows = row;
+      cols = max(cols, (long long)(stop - begin));
+    }
+  } while (nextLine(cursor, begin, stop));
+  if (!resizeCells(cells, rows, cols, name, first.line, error)) {
+    return false;
+  }
+
+  cursor = first;
+  begin = firstBegin;
+  stop = firstStop;
+  row = 0;
+  do {
+    if (begin < stop && *begin == '!') {
+      continue;
+    }
+    if (row == rows) {
+      break;
+    }
+    uint64_t *words = cells.row(int(row));
+    for (const char *at = begin; at < stop; at++) {
+      if (isLiveMark(*at)) {
+        int col = int(at - begin);
+        words[col >> 6] |= uint64_t(1) << (col & 63);
+      } else if (*at != '.') {
+        return fail(name, cursor.line,
+                    string("unexpected character '") + *at + "'", error);
+      }
+    }
+    row++;
+  } while (nextLine(cursor, begin, stop));
+  return true;
+}
+
+bool parseLifePattern(const char *data, size_t size, const string &name,
+                      LifeBitmap &cells, LifeRule &rule, string &error) {
+  Cursor cursor = {data, data + size, 0};
+  const char *begin;
+  const char *stop;
+  while (nextLine(cursor, begin, stop)) {
+    if (begin == stop || *begin == '#') {
+      continue;
+    }
+    if (isdigit((unsigned char)*begin)) {
+      return parseClassic(cursor, begin, stop, name, cells, error);
+    }
+    if (*begin == 'x' || *begin == 'X') {
+      const char *at = begin + 1;
+      while (at < stop && isspace((unsigned char)*at)) {
+        at++;
+      }
+      if (at < stop && *at == '=') {
+        // only a pattern that loads changes the rule
+        LifeRule named = rule;
+        if (!parseRle(cursor, begin, stop, name, cells, named, error)) {
+          return false;
+        }
+        rule = named;
+        return true;
+      }
+    }
+    return parsePlaintext(cursor, begin, stop, name, cells, error);
+  }
+  return fail(name, cursor.line, "the file holds no pattern", error);
+}
+
+bool parseLifePattern(const char *data, size_t size, const string &name,
+                      LifeBitmap &cells, string &error) {
+  LifeRule ignored;
+  return parseLifePattern(data, size, name, cells, ignored, error);
+}
+
+bool readLifePattern(const string &filename, LifeBitmap &cells,
+                     LifeRule &rule, string &error) {
+#ifdef _WIN32
+  ifstream input(filename, ios::binary);
+  if (!input) {
+    error = filename + " could not be opened";
+    return false;
+  }
+  string contents((istreambuf_iterator<char>(input)),
+                  istreambuf_iterator<char>());
+  return parseLifePattern(contents.data(), contents.size(), filename, cells,
+                          rule, error);
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = filename + " could not be opened";
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(fd);
+    error = filename + " is not a regular file";
+    return false;
+  }
+  size_t size = size_t(info.st_size);
+  if (size == 0) {
+    close(fd);
+    return parseLifePattern("", 0, filename, cells, rule, error);
+  }
+  void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    error = filename + " could not be mapped into memory";
+    return false;
+  }
+  madvise(mapped, size, MADV_SEQUENTIAL);
+  bool parsed = parseLifePattern(static_cast<const char *>(mapped), size,
+                                 filename, cells, rule, error);
+  munmap(mapped, size);
+  return parsed;
+#endif
+}
+
+bool readLifePattern(const string &filename, LifeBitmap &cells,
+                     string &error) {
+  LifeRule ignored;
+  return readLifePattern(filename, cells, ignored, error);
+}
@@ -0,0 +1,58 @@
+/**
+ * File: life-pattern.h
+ * --------------------
+ * Reads starting configurations for the Game of Life without any
+ * dependency on the Stanford library, so both the graphical program and
+ * the headless tools can share one loader.
+ *
+ * Three formats are understood, told apart by the first line that is
+ * not a comment:
+ *
+ *  - the format of the files in res/files: '#' comment lines, a line
+ *    holding the number of rows, a line holding the number of columns,
+ *    then one line per row with '-' for a dead cell and 'X' for a live one;
+ *  - run-length encoded (RLE) files: '#' comment lines, a header such as
+ *    "x = 3, y = 2, rule = B36/S23", then runs like "2bo$3o!", where the
+ *    rule may be any that LifeRule parses;
+ *  - plaintext (.cells) files: '!' comment lines, then one line per row
+ *    with '.' for a dead cell and 'O' for a live one.
+ *
+ * Files are memory-mapped and parsed straight into the packed bitmap,
+ * so large pattern collections load without any per-cell allocation.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+#include "life-bitmap.h"
+#include "life-rule.h"
+
+/**
+ * Function: readLifePattern
+ * -------------------------
+ * Loads the pattern stored in filename into cells, resizing it to the
+ * pattern's dimensions.  Returns false and describes the problem in
+ * error, including the line number where it applies, if the file cannot
+ * be opened or is malformed.
+ */
+bool readLifePattern(const std::string &filename, LifeBitmap &cells,
+                     std::string &error);
+
+/**
+ * Loads the pattern as above, and stores the rule an RLE header names in
+ * rule, leaving rule as it was if the file names none.
+ */
+bool readLifePattern(const std::string &filename, LifeBitmap &cells,
+                     LifeRule &rule, std::string &error);
+
+/**
+ * Function: parseLifePattern
+ * --------------------------
+ * Parses a pattern held in memory, as readLifePattern does for a file.
+ * The name is only used to prefix error messages.
+ */
+bool parseLifePattern(const char *data, size_t size, const std::string &name,
+                      LifeBitmap &cells, std::string &error);
+bool parseLifePattern(const char *data, size_t size, const std::string &name,
+                      LifeBitmap &cells, LifeRule &rule, std::string &error);
@@ -0,0 +1,430 @@
+/**
+ * File: life-recorder.cpp
+ * -----------------------
+ * Implements the Life recording format:
+ *
+ *   header   "LIFEREC1", rows, cols, keyInterval, 0     (four uint32s)
+ *   frame    kind (0 keyframe, 1 delta), varint length, payload
+ *   index    kind 2, varint count, varint gaps between keyframe offsets
+ *   footer   index offset, frame count (uint64s), "LIFEIDX1"
+ *
+ * A payload walks the bitmap's words in row-major order as pairs of
+ * varint counts, zero words skipped and literal words following.  A
+ * literal with n < 8 bits set is stored as n followed by the n bit
+ * indexes; a denser one as 8 followed by the word's 8 bytes.  Offsets
+ * are counted from the start of the header and all integers are
+ * little-endian.
+ */
+
+#include "life-recorder.h"
+
+#include <algorithm> // for min
+#include <cstring>   // for memcmp
+using namespace std;
+
+static const char kHeaderMagic[] = "LIFEREC1";
+static const char kFooterMagic[] = "LIFEIDX1";
+static const int kHeaderSize = 24;
+static const int kFooterSize = 24;
+
+enum FrameKind { KEYFRAME = 0, DELTA = 1, INDEX = 2 };
+
+static void putVarint(vector<unsigned char> &bytes, uint64_t value) {
+  while (value >= 0x80) {
+    bytes.push_back((unsigned char)(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back((unsigned char)value);
+}
+
+static void putFixed(vector<unsigned char> &bytes, uint64_t value,
+                     int width) {
+  for (int i = 0; i < width; i++) {
+    bytes.push_back((unsigned char)(value >> (8 * i)));
+  }
+}
+
+static bool getVarint(const unsigned char *&at, const unsigned char *end,
+                      uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && at < end; shift += 7) {
+    unsigned char byte = *at++;
+    value |= uint64_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static uint64_t getFixed(const unsigned char *at, int width) {
+  uint64_t value = 0;
+  for (int i = 0; i < width; i++) {
+    value |= uint64_t(at[i]) << (8 * i);
+  }
+  return value;
+}
+
+// reads a varint straight from the stream
+static bool readVarint(istream &in, uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int byte = in.get();
+    if (byte == EOF) {
+      return false;
+    }
+    value |= uint64_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void putLiteral(vector<unsigned char> &bytes, uint64_t word) {
+  int bits = __builtin_popcountll(word);
+  if (bits >= 8) {
+    bytes.push_back(8);
+    putFixed(bytes, word, 8);
+    return;
+  }
+  bytes.push_back((unsigned char)bits);
+  while (word != 0) {
+    bytes.push_back((unsigned char)__builtin_ctzll(word));
+    word &= word - 1;
+  }
+}
+
+static bool getLiteral(const unsigned char *&at, const unsigned char *end,
+                       uint64_t &word) {
+  if (at == end) {
+    return false;
+  }
+  int bits = *at++;
+  if (bits == 8) {
+    if (end - at < 8) {
+      return false;
+    }
+    word = getFixed(at, 8);
+    at += 8;
+    return true;
+  }
+  if (bits > 8 || end - at < bits) {
+    return false;
+  }
+  word = 0;
+  for (int i = 0; i < bits; i++) {
+    word |= uint64_t(1) << (*at++ & 63);
+  }
+  return true;
+}
+
+/*
+ * Appends the runs describing current XOR base (or just current when
+ * base is null) to payload.  literals is scratch space for the pending
+ * run of non-zero words.
+ */
+static void encodeWords(vector<unsigned char> &payload,
+                        vector<uint64_t> &literals, const LifeBitmap &current,
+                        const LifeBitmap *base) {
+  int words = current.wordsPerRow();
+  uint64_t zeros = 0;
+  literals.clear();
+  for (int r = 0; r < current.numRows(); r++) {
+    const uint64_t *row = current.row(r);
+    const uint64_t *baseRow = base ? base->row(r) : nullptr;
+    for (int w = 0; w < words; w++) {
+      uint64_t word = baseRow ? row[w] ^ baseRow[w] : row[w];
+      if (word != 0) {
+        literals.push_back(word);
+        continue;
+      }
+      if (!literals.empty()) {
+        putVarint(payload, zeros);
+        putVarint(payload, literals.size());
+        for (uint64_t literal : literals) {
+          putLiteral(payload, literal);
+        }
+        literals.clear();
+        zeros = 0;
+      }
+      zeros++;
+    }
+  }
+  if (!literals.empty()) {
+    putVarint(payload, zeros);
+    putVarint(payload, literals.size());
+    for (uint64_t literal : literals) {
+      putLiteral(payload, literal);
+    }
+  }
+}
+
+// XORs the runs in [at, end) into cells, returning false if they overflow
+static bool decodeWords(const unsigned char *at, const unsigned char *end,
+                        LifeBitmap &cells) {
+  uint64_t words = uint64_t(cells.wordsPerRow());
+  uint64_t total = uint64_t(cells.numRows()) * words;
+  uint64_t position = 0;
+  while (at < end) {
+    uint64_t zeros, literals;
+    if (!getVarint(at, end, zeros) || !getVarint(at, end, literals)) {
+      return false;
+    }
+    position += zeros;
+    if (position > total || literals > total - position) {
+      return false;
+    }
+    for (uint64_t i = 0; i < literals; i++, position++) {
+      uint64_t word;
+      if (!getLiteral(at, end, word)) {
+        return false;
+      }
+      int w = int(position % words);
+      if (w == int(words) - 1) {
+        word &= cells.lastWordMask();
+      }
+      cells.row(int(position / words))[w] ^= word;
+    }
+  }
+  return true;
+}
+
+LifeRecorder::LifeRecorder(ostream &out, int rows, int cols, int keyInterval)
+    : out(out), keyInterval(max(keyInterval, 1)), finished(false),
+      frameCount(0), bytesWritten(0) {
+  previous.resize(rows, cols);
+  payload.clear();
+  payload.insert(payload.end(), kHeaderMagic, kHeaderMagic + 8);
+  putFixed(payload, uint32_t(rows), 4);
+  putFixed(payload, uint32_t(cols), 4);
+  putFixed(payload, uint32_t(this->keyInterval), 4);
+  putFixed(payload, 0, 4);
+  writeBytes(payload.data(), payload.size());
+}
+
+LifeRecorder::~LifeRecorder() {
+  if (!finished) {
+    finish();
+  }
+}
+
+void LifeRecorder::writeBytes(const void *bytes, size_t count) {
+  out.write(static_cast<const char *>(bytes), count);
+  bytesWritten += count;
+}
+
+bool LifeRecorder::record(const LifeBitmap &generation) {
+  if (finished || !out || generation.numRows() != previous.numRows() ||
+      generation.numCols() != previous.numCols()) {
+    return false;
+  }
+  bool keyframe = frameCount % keyInterval == 0;
+  if (keyframe) {
+    keyframeOffsets.push_back(bytesWritten);
+  }
+  payload.clear();
+  encodeWords(payload, literals, generation, keyframe ? nullptr : &previous);
+
+  vector<unsigned char> prefix;
+  prefix.push_back(keyframe ? KEYFRAME : DELTA);
+  putVarint(prefix, payload.size());
+  writeBytes(prefix.data(), prefix.size());
+  writeBytes(payload.data(), payload.size());
+
+  // previous must become a copy of generation; only differing words change
+  for (int r = 0; r < generation.numRows(); r++) {
+    const uint64_t *from = generation.row(r);
+    copy(from, from + generation.wordsPerRow(), previous.row(r));
+  }
+  frameCount++;
+  return bool(out);
+}
+
+void LifeRecorder::finish() {
+  if (finished) {
+    return;
+  }
+  finished = true;
+  uint64_t indexOffset = bytesWritten;
+  payload.clear();
+  payload.push_back(INDEX);
+  putVarint(payload, keyframeOffsets.size());
+  uint64_t last = 0;
+  for (uint64_t offset : keyframeOffsets) {
+    putVarint(payload, offset - last);
+    last = offset;
+  }
+  putFixed(payload, indexOffset, 8);
+  putFixed(payload, frameCount, 8);
+  payload.insert(payload.end(), kFooterMagic, kFooterMagic + 8);
+  writeBytes(payload.data(), payload.size());
+  out.flush();
+}
+
+LifeReplay::LifeReplay(istream &in)
+    : in(in), fileSize(0), rows(0), cols(0), keyInterval(1), frameCount(0),
+      currentGeneration(0), haveCurrent(false) {
+  if (readHeader() && !readIndex()) {
+    error.clear();
+    scanFrames();
+  }
+}
+
+bool LifeReplay::readHeader() {
+  unsigned char header[kHeaderSize];
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char *>(header), kHeaderSize) ||
+      memcmp(header, kHeaderMagic, 8) != 0) {
+    error = "not a Life recording";
+    return false;
+  }
+  rows = int(getFixed(header + 8, 4));
+  cols = int(getFixed(header + 12, 4));
+  keyInterval = int(getFixed(header + 16, 4));
+  if (rows <= 0 || cols <= 0 || keyInterval <= 0) {
+    error = "the recording header is damaged";
+    return false;
+  }
+  current.resize(rows, cols);
+  in.seekg(0, ios::end);
+  fileSize = uint64_t(in.tellg());
+  return true;
+}
+
+bool LifeReplay::readIndex() {
+  in.clear();
+  in.seekg(0, ios::end);
+  streamoff size = in.tellg();
+  if (size < kHeaderSize + kFooterSize) {
+    error = "no index";
+    return false;
+  }
+  unsigned char footer[kFooterSize];
+  in.seekg(size - kFooterSize);
+  if (!in.read(reinterpret_cast<char *>(footer), kFooterSize) ||
+      memcmp(footer + 16, kFooterMagic, 8) != 0) {
+    error = "no index";
+    return false;
+  }
+  uint64_t indexOffset = getFixed(footer, 8);
+  frameCount = getFixed(footer + 8, 8);
+  uint64_t count;
+  in.seekg(streamoff(indexOffset));
+  if (in.get() != INDEX || !readVarint(in, count) ||
+      count != (frameCount + keyInterval - 1) / keyInterval) {
+    error = "the index is damaged";
+    return false;
+  }
+  keyframeOffsets.clear();
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    uint64_t gap;
+    if (!readVarint(in, gap)) {
+      error = "the index is damaged";
+      return false;
+    }
+    offset += gap;
+    keyframeOffsets.push_back(offset);
+  }
+  return true;
+}
+
+/*
+ * Rebuilds the index of a recording that was never finished, keeping
+ * every complete frame.
+ */
+bool LifeReplay::scanFrames() {
+  in.clear();
+  in.seekg(0, ios::end);
+  streamoff size = in.tellg();
+  keyframeOffsets.clear();
+  frameCount = 0;
+  streamoff offset = kHeaderSize;
+  in.seekg(offset);
+  while (offset < size) {
+    int kind = in.get();
+    uint64_t length;
+    if ((kind != KEYFRAME && kind != DELTA) || !readVarint(in, length)) {
+      break;
+    }
+    // a damaged length may be far past the end, so compare before adding
+    streamoff start = in.tellg();
+    bool expectKeyframe = frameCount % keyInterval == 0;
+    if (length > uint64_t(size - start) ||
+        (kind == KEYFRAME) != expectKeyframe) {
+      break;
+    }
+    streamoff next = start + streamoff(length);
+    if (kind == KEYFRAME) {
+      keyframeOffsets.push_back(uint64_t(offset));
+    }
+    frameCount++;
+    offset = next;
+    in.seekg(offset);
+  }
+  in.clear();
+  if (frameCount == 0) {
+    error = "the recording holds no complete generation";
+    return false;
+  }
+  return true;
+}
+
+bool LifeReplay::applyNextFrame(bool expectKeyframe) {
+  int kind = in.get();
+  uint64_t length;
+  if (kind != (expectKeyframe ? KEYFRAME : DELTA) ||
+      !readVarint(in, length)) {
+    error = "frame is damaged";
+    return false;
+  }
+  if (length > fileSize - uint64_t(in.tellg())) {
+    error = "frame is truncated";
+    return false;
+  }
+  payload.resize(length);
+  if (!in.read(reinterpret_cast<char *>(payload.data()), length)) {
+    error = "frame is truncated";
+    return false;
+  }
+  if (expectKeyframe) {
+    current.clear();
+  }
+  if (!decodeWords(payload.data(), payload.data() + length, current)) {
+    error = "frame is damaged";
+    return false;
+  }
+  return true;
+}
+
+bool LifeReplay::readGeneration(uint64_t generation, LifeBitmap &cells) {
+  if (!isValid()) {
+    return false;
+  }
+  if (generation >= frameCount) {
+    error = "generation " + to_string(generation) + " was not recorded";
+    return false;
+  }
+  if (!haveCurrent || generation <= currentGeneration ||
+      generation / keyInterval != currentGeneration / keyInterval) {
+    uint64_t key = generation / keyInterval;
+    in.clear();
+    in.seekg(streamoff(keyframeOffsets[key]));
+    haveCurrent = false;
+    if (!applyNextFrame(true)) {
+      return false;
+    }
+    currentGeneration = key * keyInterval;
+  }
+  while (currentGeneration < generation) {
+    if (!applyNextFrame(false)) {
+      haveCurrent = false;
+      return false;
+    }
+    currentGeneration++;
+  }
+  haveCurrent = true;
+  cells = current;
+  return true;
+}
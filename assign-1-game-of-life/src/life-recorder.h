@@ -0,0 +1,126 @@
+/**
+ * File: life-recorder.h
+ * ---------------------
+ * Defines a compact recording of a Game of Life run and a reader that
+ * replays it from any generation.
+ *
+ * Every keyInterval-th generation is stored as a keyframe; the others are
+ * stored as the XOR of their packed liveness bitmap with the previous
+ * generation's.  Both kinds of frame are written as runs of all-zero words
+ * (varint counts) followed by the literal non-zero words, so a settled
+ * board costs a few bytes per generation.  The file ends with an index of
+ * keyframe offsets, letting the reader reach generation g by decoding one
+ * keyframe and at most keyInterval - 1 deltas.
+ *
+ * Only liveness is recorded, not ages.  The recorder writes to any
+ * std::ostream, which includes the library's ofbitstream, and the reader
+ * needs a seekable std::istream such as ifbitstream.
+ */
+
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "life-bitmap.h"
+
+class LifeRecorder {
+public:
+  /**
+   * Starts a recording of a rows x cols board on out, writing a keyframe
+   * every keyInterval generations.
+   */
+  LifeRecorder(std::ostream &out, int rows, int cols, int keyInterval = 64);
+
+  /**
+   * Calls finish if the client has not, so the stream must outlive the
+   * recorder.
+   */
+  ~LifeRecorder();
+
+  /**
+   * Appends the next generation.  The first call records generation 0.
+   * Returns false if the bitmap has the wrong dimensions or the stream
+   * has failed.
+   */
+  bool record(const LifeBitmap &generation);
+
+  /**
+   * Writes the keyframe index and flushes the stream.  No generations may
+   * be recorded afterwards.
+   */
+  void finish();
+
+  uint64_t getFrameCount() const { return frameCount; }
+
+  /**
+   * Returns the number of bytes written so far.
+   */
+  uint64_t getBytesWritten() const { return bytesWritten; }
+
+private:
+  std::ostream &out;
+  int keyInterval;
+  bool finished;
+  uint64_t frameCount;
+  uint64_t bytesWritten;
+  LifeBitmap previous;
+  std::vector<uint64_t> keyframeOffsets;
+  std::vector<unsigned char> payload; // reused for every frame
+  std::vector<uint64_t> literals;
+
+  void writeBytes(const void *bytes, size_t count);
+
+  LifeRecorder(const LifeRecorder &original);
+  void operator=(const LifeRecorder &rhs) const;
+};
+
+class LifeReplay {
+public:
+  /**
+   * Opens a recording made by LifeRecorder.  If the index is missing
+   * because the recording was cut short, the frames are scanned to
+   * rebuild it.  Check isValid before using the replay.
+   */
+  explicit LifeReplay(std::istream &in);
+
+  bool isValid() const { return error.empty(); }
+  const std::string &getError() const { return error; }
+
+  int numRows() const { return rows; }
+  int numCols() const { return cols; }
+  int getKeyInterval() const { return keyInterval; }
+  uint64_t getFrameCount() const { return frameCount; }
+
+  /**
+   * Stores the given generation in cells.  Reading forward within the
+   * same keyframe interval only applies the deltas in between; any other
+   * generation starts from the nearest keyframe at or before it, so no
+   * read decodes more than keyInterval frames.  Returns false and sets the
+   * error if the generation was not recorded or the file is damaged.
+   */
+  bool readGeneration(uint64_t generation, LifeBitmap &cells);
+
+private:
+  std::istream &in;
+  uint64_t fileSize; // frame lengths past this are damage
+  std::string error;
+  int rows;
+  int cols;
+  int keyInterval;
+  uint64_t frameCount;
+  std::vector<uint64_t> keyframeOffsets;
+  LifeBitmap current;
+  uint64_t currentGeneration; // valid when haveCurrent
+  bool haveCurrent;
+  std::vector<unsigned char> payload;
+
+  bool readHeader();
+  bool readIndex();
+  bool scanFrames();
+  bool applyNextFrame(bool expectKeyframe);
+
+  LifeReplay(const LifeReplay &original);
+  void operator=(const LifeReplay &rhs) const;
+};
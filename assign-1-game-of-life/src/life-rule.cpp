@@ -0,0 +1,161 @@
+/**
+ * File: life-rule.cpp
+ * -------------------
+ * Implements parsing and compiling of Life-like rules.
+ */
+
+#include "life-rule.h"
+
+#include <cctype> // for isdigit, isspace, toupper
+#include <vector>
+using namespace std;
+
+// Conway's Life: born with 3 neighbours, survives with 2 or 3
+static const int kConwayBirth = 1 << 3;
+static const int kConwaySurvival = (1 << 2) | (1 << 3);
+
+// the most states a Generations rule may have
+static const int kMaxStates = 256;
+
+LifeRule::LifeRule()
+    : birthMask(kConwayBirth), survivalMask(kConwaySurvival), states(2) {
+  compile();
+}
+
+// parses the neighbour counts from part[begin] onwards into a mask
+static bool parseCounts(const string &part, size_t begin, int &mask,
+                        string &error) {
+  mask = 0;
+  for (size_t i = begin; i < part.size(); i++) {
+    if (part[i] < '0' || part[i] > '8') {
+      error = "\"" + part + "\" should list neighbour counts from 0 to 8";
+      return false;
+    }
+    mask |= 1 << (part[i] - '0');
+  }
+  return true;
+}
+
+// parses the state count from part[begin] onwards
+static bool parseStates(const string &part, size_t begin, int &states,
+                        string &error) {
+  states = 0;
+  for (size_t i = begin; i < part.size(); i++) {
+    if (!isdigit((unsigned char)part[i]) || states > kMaxStates) {
+      states = 0;
+      break;
+    }
+    states = states * 10 + (part[i] - '0');
+  }
+  if (states < 2 || states > kMaxStates) {
+    error = "\"" + part + "\" should give between 2 and " +
+            to_string(kMaxStates) + " states";
+    return false;
+  }
+  return true;
+}
+
+bool LifeRule::parse(const string &spec, LifeRule &rule, string &error) {
+  vector<string> parts(1);
+  for (char ch : spec) {
+    if (ch == '/') {
+      parts.push_back("");
+    } else if (!isspace((unsigned char)ch)) {
+      parts.back() += (char)toupper((unsigned char)ch);
+    }
+  }
+  if (parts.size() < 2 || parts.size() > 3) {
+    error = "a rule looks like B3/S23, 23/3 or B2/S/C3";
+    return false;
+  }
+
+  int birth = 0;
+  int survival = 0;
+  int states = 2;
+  bool lettered = false;
+  for (const string &part : parts) {
+    if (!part.empty() && !isdigit((unsigned char)part[0])) {
+      lettered = true;
+    }
+  }
+  if (lettered) {
+    bool seen[3] = {false, false, false};
+    for (const string &part : parts) {
+      int which = part.empty() ? -1 : (int)string("BSC").find(part[0]);
+      if (which < 0 || seen[which]) {
+        error = "\"" + part + "\" should be one B, S or C part of the rule";
+        return false;
+      }
+      seen[which] = true;
+      bool parsed;
+      if (which == 0) {
+        parsed = parseCounts(part, 1, birth, error);
+      } else if (which == 1) {
+        parsed = parseCounts(part, 1, survival, error);
+      } else {
+        parsed = parseStates(part, 1, states, error);
+      }
+      if (!parsed) {
+        return false;
+      }
+    }
+    if (!seen[0] || !seen[1]) {
+      error = "the rule needs both a B and an S part";
+      return false;
+    }
+  } else {
+    // the older notation lists survival first: S/B or S/B/C
+    if (!parseCounts(parts[0], 0, survival, error) ||
+        !parseCounts(parts[1], 0, birth, error) ||
+        (parts.size() == 3 && !parseStates(parts[2], 0, states, error))) {
+      return false;
+    }
+  }
+
+  rule.birthMask = birth;
+  rule.survivalMask = survival;
+  rule.states = states;
+  rule.compile();
+  return true;
+}
+
+string LifeRule::toString() const {
+  string result = "B";
+  for (int n = 0; n <= 8; n++) {
+    if (birthMask & (1 << n)) {
+      result += char('0' + n);
+    }
+  }
+  result += "/S";
+  for (int n = 0; n <= 8; n++) {
+    if (survivalMask & (1 << n)) {
+      result += char('0' + n);
+    }
+  }
+  if (states > 2) {
+    result += "/C" + to_string(states);
+  }
+  return result;
+}
+
+bool LifeRule::isConway() const {
+  return birthMask == kConwayBirth && survivalMask == kConwaySurvival &&
+         states == 2;
+}
+
+bool LifeRule::operator==(const LifeRule &other) const {
+  return birthMask == other.birthMask && survivalMask == other.survivalMask &&
+         states == other.states;
+}
+
+void LifeRule::compile() {
+  for (int index = 0; index < 512; index++) {
+    int neighbours = __builtin_popcount(index & ~(1 << 4));
+    int mask = (index & (1 << 4)) ? survivalMask : birthMask;
+    table[index] = (unsigned char)((mask >> neighbours) & 1);
+  }
+  for (int n = 0; n <= 8; n++) {
+    selectors[n] = ((birthMask >> n) & 1) ? ~uint64_t(0) : 0;
+    selectors[9 + n] = ((survivalMask >> n) & 1) ? ~uint64_t(0) : 0;
+  }
+}
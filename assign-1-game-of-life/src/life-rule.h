@@ -0,0 +1,85 @@
+/**
+ * File: life-rule.h
+ * -----------------
+ * Defines the rule of a Life-like cellular automaton: the neighbour
+ * counts at which a dead cell is born and a live cell survives, plus,
+ * for the "Generations" family, how many states a cell passes through.
+ *
+ * Rules are written in B/S notation, for example "B3/S23" for Conway's
+ * Life or "B36/S23" for HighLife, or in the older S/B form "23/3".  A
+ * third part gives the number of states of a Generations rule, as in
+ * "B2/S/C3" or "/2/3" for Brian's Brain: a live cell that does not
+ * survive spends states 2 to C - 1 dying, during which it neither counts
+ * as a neighbour nor can be born into.
+ *
+ * A parsed rule is compiled once into the forms the evolution loops use,
+ * so switching rules changes data rather than adding tests per cell.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+class LifeRule {
+public:
+  /**
+   * Creates Conway's B3/S23.
+   */
+  LifeRule();
+
+  /**
+   * Parses spec into rule.  Letters may be in either case and spaces are
+   * ignored.  Returns false and describes the problem in error if spec is
+   * not a rule.
+   */
+  static bool parse(const std::string &spec, LifeRule &rule,
+                    std::string &error);
+
+  /**
+   * Returns the rule in B/S notation, with a "/C" part for Generations
+   * rules.
+   */
+  std::string toString() const;
+
+  /**
+   * Bit n of the masks is set if n neighbours give birth or survival.
+   */
+  int getBirthMask() const { return birthMask; }
+  int getSurvivalMask() const { return survivalMask; }
+
+  /**
+   * Returns the number of states a cell can be in: 2 for a plain
+   * Life-like rule, more for a Generations rule.
+   */
+  int getStates() const { return states; }
+
+  bool isConway() const;
+
+  /**
+   * Returns the 512-entry table giving whether the centre of a 3x3
+   * neighbourhood is alive next generation.  Bit 3 * dr + dc of the index
+   * is set if the cell at offset (dr - 1, dc - 1) is alive now, so bit 4
+   * is the centre itself.
+   */
+  const unsigned char *getTable() const { return table; }
+
+  /**
+   * Returns 18 words, each all ones or all zeros: word n tells whether a
+   * dead cell with n neighbours is born, word 9 + n whether a live one
+   * survives.  The packed kernels combine them with the neighbour count
+   * bit-planes using only bitwise operations.
+   */
+  const uint64_t *getSelectors() const { return selectors; }
+
+  bool operator==(const LifeRule &other) const;
+  bool operator!=(const LifeRule &other) const { return !(*this == other); }
+
+private:
+  int birthMask;
+  int survivalMask;
+  int states;
+  unsigned char table[512];
+  uint64_t selectors[18];
+
+  void compile();
+};
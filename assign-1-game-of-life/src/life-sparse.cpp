@@ -0,0 +1,272 @@
+/**
+ * File: life-sparse.cpp
+ * ---------------------
+ * Implements the chunked Game of Life engine for an unbounded plane.
+ * Each generation visits the existing chunks plus any empty neighbour
+ * that a live border cell could spill into, evolves each of them with
+ * the packed row kernel, and then frees the chunks left empty.
+ */
+
+#include "life-sparse.h"
+
+#include <algorithm>     // for min, max
+#include <unordered_set> // for unordered_set
+using namespace std;
+
+#include "life-constants.h" // for kMaxAge
+
+static uint64_t chunkKey(int chunkRow, int chunkCol) {
+  return (uint64_t(uint32_t(chunkRow)) << 32) | uint32_t(chunkCol);
+}
+
+static int keyRow(uint64_t key) { return int32_t(uint32_t(key >> 32)); }
+static int keyCol(uint64_t key) { return int32_t(uint32_t(key)); }
+
+// chunk coordinate of a cell coordinate, rounding towards negative infinity
+static int chunkOf(int coordinate) {
+  return coordinate >= 0 ? coordinate / 64 : -((-(coordinate + 1)) / 64) - 1;
+}
+
+size_t SparseLifeEngine::ChunkKeyHash::operator()(uint64_t key) const {
+  key ^= key >> 33;
+  key *= 0xFF51AFD7ED558CCDULL;
+  key ^= key >> 33;
+  return size_t(key);
+}
+
+SparseLifeEngine::SparseLifeEngine()
+    : rows(0), cols(0), generation(0), seed(0), liveHash(0), stable(false) {
+  string kernelName;
+  kernel = PackedLifeEngine::selectRowKernel(getRule(), kernelName);
+}
+
+void SparseLifeEngine::ruleChanged() {
+  string kernelName;
+  kernel = PackedLifeEngine::selectRowKernel(getRule(), kernelName);
+}
+
+void SparseLifeEngine::setDimensions(int rows, int cols) {
+  this->rows = rows;
+  this->cols = cols;
+  chunks.clear();
+  generation = 0;
+  liveHash = 0;
+  stable = false;
+}
+
+const SparseLifeEngine::Chunk *SparseLifeEngine::findChunk(int chunkRow,
+                                                           int chunkCol) const {
+  auto found = chunks.find(chunkKey(chunkRow, chunkCol));
+  return found == chunks.end() ? nullptr : found->second.get();
+}
+
+int SparseLifeEngine::getAge(int row, int col) const {
+  int chunkRow = chunkOf(row);
+  int chunkCol = chunkOf(col);
+  const Chunk *chunk = findChunk(chunkRow, chunkCol);
+  if (chunk == nullptr) {
+    return 0;
+  }
+  int r = row - chunkRow * kChunkSize;
+  int c = col - chunkCol * kChunkSize;
+  if (!((chunk->rows[r] >> c) & 1)) {
+    return 0;
+  }
+  uint32_t age = generation - chunk->origins[r * kChunkSize + c];
+  return (int)min(age, uint32_t(kMaxAge));
+}
+
+void SparseLifeEngine::setAge(int row, int col, int age) {
+  age = min(max(age, 0), kMaxAge);
+  int chunkRow = chunkOf(row);
+  int chunkCol = chunkOf(col);
+  uint64_t key = chunkKey(chunkRow, chunkCol);
+  auto found = chunks.find(key);
+  if (found == chunks.end()) {
+    if (age == 0) {
+      return;
+    }
+    found = chunks.emplace(key, unique_ptr<Chunk>(new Chunk())).first;
+  }
+  Chunk &chunk = *found->second;
+  int r = row - chunkRow * kChunkSize;
+  int c = col - chunkCol * kChunkSize;
+  uint64_t bit = uint64_t(1) << c;
+  if (((chunk.rows[r] & bit) != 0) != (age > 0)) {
+    liveHash ^= lifeCellKey(row, col);
+  }
+  if (age > 0) {
+    chunk.rows[r] |= bit;
+    chunk.origins[r * kChunkSize + c] = generation - age;
+  } else {
+    chunk.rows[r] &= ~bit;
+    if (all_of(chunk.rows, chunk.rows + kChunkSize,
+               [](uint64_t word) { return word == 0; })) {
+      chunks.erase(found);
+    }
+  }
+}
+
+/*
+ * Lists every chunk that may hold live cells next generation: the
+ * existing chunks plus absent neighbours facing a non-empty border.
+ */
+void SparseLifeEngine::collectCandidates(vector<uint64_t> &candidates) const {
+  unordered_set<uint64_t, ChunkKeyHash> seen;
+  for (const auto &entry : chunks) {
+    const Chunk &chunk = *entry.second;
+    seen.insert(entry.first);
+    uint64_t columns = 0;
+    for (int r = 0; r < kChunkSize; r++) {
+      columns |= chunk.rows[r];
+    }
+    bool north = chunk.rows[0] != 0;
+    bool south = chunk.rows[kChunkSize - 1] != 0;
+    bool west = (columns & 1) != 0;
+    bool east = (columns >> (kChunkSize - 1)) != 0;
+    int chunkRow = keyRow(entry.first);
+    int chunkCol = keyCol(entry.first);
+    for (int dr = -1; dr <= 1; dr++) {
+      for (int dc = -1; dc <= 1; dc++) {
+        bool facing = (dr != -1 || north) && (dr != 1 || south) &&
+                      (dc != -1 || west) && (dc != 1 || east);
+        if (facing && (dr != 0 || dc != 0)) {
+          seen.insert(chunkKey(chunkRow + dr, chunkCol + dc));
+        }
+      }
+    }
+  }
+  candidates.assign(seen.begin(), seen.end());
+}
+
+/*
+ * Computes the next generation of one chunk into out.  The chunk and the
+ * facing edges of its eight neighbours are copied into a 66-row strip of
+ * three words, so the row kernel sees one cell of halo on every side.
+ */
+void SparseLifeEngine::evolveChunk(uint64_t key, uint64_t *out) const {
+  int chunkRow = keyRow(key);
+  int chunkCol = keyCol(key);
+  const Chunk *around[3][3];
+  for (int dr = -1; dr <= 1; dr++) {
+    for (int dc = -1; dc <= 1; dc++) {
+      around[dr + 1][dc + 1] = findChunk(chunkRow + dr, chunkCol + dc);
+    }
+  }
+
+  uint64_t strip[kChunkSize + 2][3];
+  for (int i = 0; i < kChunkSize + 2; i++) {
+    int band = i == 0 ? 0 : (i == kChunkSize + 1 ? 2 : 1);
+    int r = i == 0 ? kChunkSize - 1 : (i == kChunkSize + 1 ? 0 : i - 1);
+    for (int w = 0; w < 3; w++) {
+      const Chunk *chunk = around[band][w];
+      strip[i][w] = chunk == nullptr ? 0 : chunk->rows[r];
+    }
+  }
+  for (int r = 0; r < kChunkSize; r++) {
+    kernel(&strip[r][1], &strip[r + 1][1], &strip[r + 2][1], &out[r], 1,
+           getRule());
+  }
+}
+
+void SparseLifeEngine::evolve() {
+  vector<uint64_t> candidates;
+  collectCandidates(candidates);
+  vector<uint64_t> nextRows(candidates.size() * kChunkSize);
+  for (size_t i = 0; i < candidates.size(); i++) {
+    evolveChunk(candidates[i], &nextRows[i * kChunkSize]);
+  }
+
+  stable = true;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    const uint64_t *after = &nextRows[i * kChunkSize];
+    bool alive = any_of(after, after + kChunkSize,
+                        [](uint64_t word) { return word != 0; });
+    auto found = chunks.find(candidates[i]);
+    if (found == chunks.end()) {
+      if (!alive) {
+        continue;
+      }
+      found = chunks.emplace(candidates[i], unique_ptr<Chunk>(new Chunk()))
+                  .first;
+    }
+    Chunk &chunk = *found->second;
+    int firstRow = keyRow(candidates[i]) * kChunkSize;
+    int firstCol = keyCol(candidates[i]) * kChunkSize;
+    for (int r = 0; r < kChunkSize; r++) {
+      uint64_t before = chunk.rows[r];
+      if (before & ~after[r]) {
+        stable = false;
+      }
+      uint64_t flipped = before ^ after[r];
+      while (flipped != 0) {
+        int c = __builtin_ctzll(flipped);
+        flipped &= flipped - 1;
+        liveHash ^= lifeCellKey(firstRow + r, firstCol + c);
+      }
+      uint64_t births = after[r] & ~before;
+      while (births != 0) {
+        int c = __builtin_ctzll(births);
+        births &= births - 1;
+        int age =
+            lifeBirthAge(seed, generation + 1, firstRow + r, firstCol + c);
+        chunk.origins[r * kChunkSize + c] = generation + 1 - age;
+        if (age != 1) {
+          stable = false;
+        }
+      }
+      chunk.rows[r] = after[r];
+    }
+    if (!alive) {
+      chunks.erase(found);
+    }
+  }
+  generation++;
+}
+
+bool SparseLifeEngine::getBounds(int &top, int &left, int &bottom,
+                                 int &right) const {
+  bool any = false;
+  for (const auto &entry : chunks) {
+    const Chunk &chunk = *entry.second;
+    int firstRow = keyRow(entry.first) * kChunkSize;
+    int firstCol = keyCol(entry.first) * kChunkSize;
+    uint64_t columns = 0;
+    int minRow = kChunkSize, maxRow = -1;
+    for (int r = 0; r < kChunkSize; r++) {
+      if (chunk.rows[r] != 0) {
+        columns |= chunk.rows[r];
+        minRow = min(minRow, r);
+        maxRow = r;
+      }
+    }
+    if (columns == 0) {
+      continue;
+    }
+    int minCol = __builtin_ctzll(columns);
+    int maxCol = 63 - __builtin_clzll(columns);
+    if (!any) {
+      top = firstRow + minRow;
+      bottom = firstRow + maxRow;
+      left = firstCol + minCol;
+      right = firstCol + maxCol;
+      any = true;
+    } else {
+      top = min(top, firstRow + minRow);
+      bottom = max(bottom, firstRow + maxRow);
+      left = min(left, firstCol + minCol);
+      right = max(right, firstCol + maxCol);
+    }
+  }
+  return any;
+}
+
+uint64_t SparseLifeEngine::getPopulation() const {
+  uint64_t population = 0;
+  for (const auto &entry : chunks) {
+    for (uint64_t word : entry.second->rows) {
+      population += __builtin_popcountll(word);
+    }
+  }
+  return population;
+}
@@ -0,0 +1,85 @@
+/**
+ * File: life-sparse.h
+ * -------------------
+ * Defines a Game of Life engine for an unbounded plane.  Live regions
+ * are stored as 64x64 chunks in a hash map keyed by chunk coordinate;
+ * chunks are allocated when something is born in them and freed as soon
+ * as they empty out, so memory follows the population rather than the
+ * bounding box of everything that ever lived.
+ *
+ * Birth ages come from lifeBirthAge, so results do not depend on the
+ * order in which chunks are visited.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "life-engine.h"
+#include "life-packed.h" // for PackedLifeEngine::RowKernel
+
+class SparseLifeEngine : public LifeEngine {
+public:
+  SparseLifeEngine();
+
+  std::string getName() const override { return "sparse"; }
+
+  /**
+   * Records the size of the window being displayed and empties the plane.
+   */
+  void setDimensions(int rows, int cols) override;
+  int numRows() const override { return rows; }
+  int numCols() const override { return cols; }
+  int getAge(int row, int col) const override;
+  void setAge(int row, int col, int age) override;
+  void evolve() override;
+  bool isStable() const override { return stable; }
+  bool isUnbounded() const override { return true; }
+  uint64_t getLiveHash() const override { return liveHash; }
+  bool getBounds(int &top, int &left, int &bottom, int &right) const override;
+
+  /**
+   * Returns the number of chunks currently allocated.
+   */
+  size_t getChunkCount() const { return chunks.size(); }
+
+  /**
+   * Returns the number of live cells on the plane.
+   */
+  uint64_t getPopulation() const;
+
+  /**
+   * Sets the seed mixed into every birth age.
+   */
+  void setSeed(uint64_t seed) { this->seed = seed; }
+
+private:
+  static const int kChunkSize = 64;
+
+  struct Chunk {
+    uint64_t rows[kChunkSize];                 // bit c of rows[r] is (r, c)
+    uint32_t origins[kChunkSize * kChunkSize]; // age is generation - origin
+  };
+
+  struct ChunkKeyHash {
+    size_t operator()(uint64_t key) const;
+  };
+
+  int rows;
+  int cols;
+  uint32_t generation;
+  uint64_t seed;
+  uint64_t liveHash;
+  bool stable;
+  PackedLifeEngine::RowKernel kernel;
+  std::unordered_map<uint64_t, std::unique_ptr<Chunk>, ChunkKeyHash> chunks;
+
+  const Chunk *findChunk(int chunkRow, int chunkCol) const;
+  void ruleChanged() override;
+  void collectCandidates(std::vector<uint64_t> &candidates) const;
+  void evolveChunk(uint64_t key, uint64_t *out) const;
+};
@@ -0,0 +1,108 @@
+/**
+ * File: life-threadpool.cpp
+ * -------------------------
+ * Implements the work-stealing thread pool.
+ */
+
+#include "life-threadpool.h"
+
+#include <algorithm> // for max
+using namespace std;
+
+LifeThreadPool::LifeThreadPool(int threads)
+    : body(nullptr), remaining(0), round(0), stopping(false) {
+  if (threads <= 0) {
+    threads = max(1, (int)thread::hardware_concurrency());
+  }
+  for (int i = 0; i < threads; i++) {
+    queues.emplace_back(new TaskQueue());
+  }
+  // queue 0 belongs to the thread that calls run
+  for (int i = 1; i < threads; i++) {
+    this->threads.emplace_back(&LifeThreadPool::workerLoop, this, i);
+  }
+}
+
+LifeThreadPool::~LifeThreadPool() {
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (thread &worker : threads) {
+    worker.join();
+  }
+}
+
+void LifeThreadPool::run(int tasks, const function<void(int)> &body) {
+  if (tasks <= 0) {
+    return;
+  }
+  {
+    lock_guard<mutex> guard(lock);
+    this->body = &body;
+    remaining = tasks;
+    for (int task = 0; task < tasks; task++) {
+      TaskQueue &queue = *queues[task % queues.size()];
+      lock_guard<mutex> queueGuard(queue.lock);
+      queue.tasks.push_back(task);
+    }
+    round++;
+  }
+  wake.notify_all();
+  drain(0);
+
+  unique_lock<mutex> guard(lock);
+  finished.wait(guard, [this] { return remaining == 0; });
+  this->body = nullptr;
+}
+
+void LifeThreadPool::workerLoop(int index) {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      unique_lock<mutex> guard(lock);
+      wake.wait(guard, [&] { return stopping || round != seen; });
+      if (stopping) {
+        return;
+      }
+      seen = round;
+    }
+    drain(index);
+  }
+}
+
+void LifeThreadPool::drain(int index) {
+  int task;
+  while (takeTask(index, task)) {
+    (*body)(task);
+    if (--remaining == 0) {
+      lock_guard<mutex> guard(lock);
+      finished.notify_all();
+    }
+  }
+}
+
+/*
+ * Pops from the back of this thread's own queue, falling back to
+ * stealing from the front of the other queues in turn.
+ */
+bool LifeThreadPool::takeTask(int index, int &task) {
+  int count = (int)queues.size();
+  for (int offset = 0; offset < count; offset++) {
+    TaskQueue &queue = *queues[(index + offset) % count];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    if (offset == 0) {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+    } else {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,60 @@
+/**
+ * File: life-threadpool.h
+ * -----------------------
+ * Defines a small work-stealing thread pool.  Each call to run hands out
+ * a batch of numbered tasks round-robin to per-thread queues; a thread
+ * works from the back of its own queue and steals from the front of the
+ * others when it runs dry.  run returns only after every task of the
+ * batch has finished, so consecutive calls are separated by a barrier.
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class LifeThreadPool {
+public:
+  /**
+   * Creates a pool of the given number of threads, counting the thread
+   * that calls run.  Zero means one per hardware thread.
+   */
+  explicit LifeThreadPool(int threads = 0);
+  ~LifeThreadPool();
+
+  int numThreads() const { return (int)queues.size(); }
+
+  /**
+   * Runs body(0) ... body(tasks - 1) across the pool and waits for all
+   * of them to finish.  The calling thread takes part in the work.
+   */
+  void run(int tasks, const std::function<void(int)> &body);
+
+private:
+  struct TaskQueue {
+    std::mutex lock;
+    std::deque<int> tasks;
+  };
+
+  std::vector<std::unique_ptr<TaskQueue>> queues;
+  std::vector<std::thread> threads;
+  std::mutex lock;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  const std::function<void(int)> *body;
+  std::atomic<int> remaining;
+  unsigned long round;
+  bool stopping;
+
+  void workerLoop(int index);
+  void drain(int index);
+  bool takeTask(int index, int &task);
+
+  LifeThreadPool(const LifeThreadPool &original);
+  void operator=(const LifeThreadPool &rhs) const;
+};
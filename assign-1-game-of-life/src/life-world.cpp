@@ -0,0 +1,33 @@
+/**
+ * File: life-world.cpp
+ * --------------------
+ * Implements the double-buffered Life world.
+ */
+
+#include "life-world.h"
+
+#include <algorithm> // for fill, swap
+#include <cstdint>   // for uintptr_t
+using namespace std;
+
+LifeWorld::LifeWorld() : rows(0), cols(0), stride(0) {
+  planes[0] = planes[1] = nullptr;
+}
+
+void LifeWorld::resize(int rows, int cols) {
+  this->rows = rows;
+  this->cols = cols;
+  stride = (cols + kAlignInts - 1) / kAlignInts * kAlignInts;
+  size_t planeSize = size_t(rows) * stride;
+
+  // the slack lets the first plane start on a 64-byte boundary; resize
+  // only reallocates when the vector's capacity is exceeded
+  storage.resize(2 * planeSize + kAlignInts);
+  uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+  size_t skip = (64 - address % 64) % 64 / sizeof(int);
+  planes[0] = storage.data() + skip;
+  planes[1] = planes[0] + planeSize;
+  fill(planes[0], planes[1] + planeSize, 0);
+}
+
+void LifeWorld::swap() { std::swap(planes[0], planes[1]); }
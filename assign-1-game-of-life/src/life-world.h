@@ -0,0 +1,74 @@
+/**
+ * File: life-world.h
+ * ------------------
+ * Defines the double-buffered board used by the classic Game of Life
+ * evolution.  A world owns two planes of cell ages: the current
+ * generation, and a back plane that evolve writes the next generation
+ * into.  swap exchanges the two by pointer, so after it the back plane
+ * holds the previous generation, which is what the stability check
+ * compares against.
+ *
+ * Each plane starts on a 64-byte boundary and rows are padded to a
+ * whole number of cache lines.  Resizing reuses the existing storage
+ * whenever it is large enough, so nothing on the per-generation path
+ * allocates or copies a board.
+ */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+class LifeWorld {
+public:
+  LifeWorld();
+
+  /**
+   * Resizes both planes to rows x cols and kills every cell.
+   */
+  void resize(int rows, int cols);
+
+  int numRows() const { return rows; }
+  int numCols() const { return cols; }
+
+  bool inBounds(int row, int col) const {
+    return row >= 0 && row < rows && col >= 0 && col < cols;
+  }
+
+  /**
+   * Returns the ages of one row of the current generation.
+   */
+  int *row(int r) { return planes[0] + size_t(r) * stride; }
+  const int *row(int r) const { return planes[0] + size_t(r) * stride; }
+
+  /**
+   * Returns the same row of the back plane: the generation being written
+   * before swap, and the previous generation after it.
+   */
+  int *backRow(int r) { return planes[1] + size_t(r) * stride; }
+  const int *backRow(int r) const { return planes[1] + size_t(r) * stride; }
+
+  /**
+   * Returns the distance in ints between the starts of adjacent rows.
+   */
+  int rowStride() const { return stride; }
+
+  int get(int row, int col) const { return this->row(row)[col]; }
+  void set(int row, int col, int age) { this->row(row)[col] = age; }
+
+  /**
+   * Makes the back plane the current generation and vice versa.
+   */
+  void swap();
+
+private:
+  static const int kAlignInts = 64 / sizeof(int);
+
+  int rows;
+  int cols;
+  int stride; // ints per row, a multiple of kAlignInts
+  std::vector<int> storage;
+  int *planes[2];
+
+  LifeWorld(const LifeWorld &original);
+  void operator=(const LifeWorld &rhs) const;
+};
@@ -4,49 +4,101 @@
  * Implements the Game of Life.
  */
 
+#include <algorithm> // for min
 #include <cstdio>
-#include <fstream>  // open file
 #include <iostream> // for cout
+#include <memory>   // for unique_ptr
 #include <string>   // play with string
+#include <vector>
 // enable sleeping
 #include <chrono> // std::chrono::seconds
 #include <thread> // std::this_thread::sleep_for
 
 using namespace std;
 
+#include "bitstream.h" // for ifbitstream, ofbitstream
 #include "console.h" // required of all files that contain the main function
 #include "gevents.h" // for mouse event detection
+#include "grid.h"    // for GridView, forEachStencil
 #include "gtimer.h"
 #include "simpio.h" // for getLine
 #include "strlib.h"
 
 #include "life-constants.h" // for kMaxAge
+#include "life-cycle.h"     // for LifeCycleDetector
+#include "life-engine.h"    // for createLifeEngine
 #include "life-graphics.h"  // for class LifeDisplay
+#include "life-pattern.h"   // for readLifePattern
+#include "life-recorder.h"  // for LifeRecorder, LifeReplay
+#include "life-rule.h"      // for LifeRule
+#include "life-world.h"     // for LifeWorld
+
+// longest oscillation period recognized before the animation stops
+static const int kMaxCyclePeriod = 64;
+
+// larger boards are drawn into a pixel buffer instead of one GOval per cell
+static const int kMaxOvalCells = 100 * 100;
+
+// generations between keyframes of a recording, the most a seek replays
+static const int kRecordKeyInterval = 64;
 
 /**
  * Function: welcome
  * -----------------
- * Introduces the user to the Game of Life and its rules.
+ * Introduces the user to the Game of Life, lets them pick its rule and
+ * explains it.
  */
-static void welcome(int &ms);
+static void welcome(LifeRule &rule, int &ms);
+
+// ask for a rule in B/S notation, blank keeps B3/S23
+static LifeRule chooseRule();
+
+// the neighbour counts set in a rule mask, such as "2 or 3"
+static string describeCounts(int mask);
+
+// load starting configuraiton from file (plain, RLE or plaintext) or randomly,
+// switching to the rule an RLE file names
+static void getStartConfig(LifeWorld &world, LifeRule &rule);
 
-// load starting configuraiton from file or randomly
-static void getStartConfig(int &row, int &column, vector<Grid<int>> &worlds);
+// choose a stepping engine that runs the rule, nullptr keeps the classic
+// LifeWorld evolution
+static unique_ptr<LifeEngine> chooseEngine(const LifeRule &rule);
+
+// copy the starting configuration into an engine
+static void loadEngine(LifeEngine &engine, LifeWorld &world);
 
 // draw the world on display
-static void drawOnDisp(Grid<int> &world, LifeDisplay &display);
+static void drawOnDisp(LifeWorld &world, LifeDisplay &display);
+static void drawOnDisp(LifeEngine &engine, LifeDisplay &display);
+
+// evolve the world one day, flipping changed cells in and out of liveHash
+static void evolveWorld(LifeWorld &world, const LifeRule &rule,
+                        uint64_t &liveHash);
+
+// Zobrist hash of the live cells of a world
+static uint64_t hashWorld(LifeWorld &world);
 
-// evolve the world one day
-static void evolveWorld(vector<Grid<int>> &worlds, int &curIdx);
+// live cells around and including a cell, as an index into the rule table
+static int getNeighbourhood(LifeWorld &world, int row, int col);
 
-// Count number of neighbours of a cell
-static int countNeighbours(Grid<int> &world, int &row, int &col);
+// store the neighbourhood of every cell in the back plane of the world
+static void getNeighbourhoods(LifeWorld &world);
 
 // checks if stable
-static bool checkStable(vector<Grid<int>> &worlds, int &curIdx);
+static bool checkStable(LifeWorld &world);
 
-static void runAnimation(LifeDisplay &display, vector<Grid<int>> &worlds,
-                         int &curIdx, int ms);
+// copy the live cells on display into a bitmap for the recorder
+static void snapshot(LifeWorld &world, LifeBitmap &cells);
+static void snapshot(LifeEngine &engine, LifeDisplay &display,
+                     LifeBitmap &cells);
+
+// play a recording back from a chosen generation
+static void replayRecording(LifeDisplay &display, const string &filename,
+                            int ms);
+
+static void runAnimation(LifeDisplay &display, LifeWorld &world,
+                         const LifeRule &rule, int ms, LifeEngine *engine,
+                         LifeRecorder *recorder);
 /**
  * Function: main
  * --------------
@@ -54,24 +106,43 @@ static void runAnimation(LifeDisplay &display, vector<Grid<int>> &worlds,
  */
 int main() {
   LifeDisplay display;
-  // prepare row and column
-  int row = 0, column = 0;
-  int curIdx = 0;
   int ms = 0;
   string command;
   bool exit_game = false;
 
-  // current world and next world
-  vector<Grid<int>> worlds;
+  // current world and next world, reused across runs
+  LifeWorld world;
+  LifeRule rule;
+  unique_ptr<LifeEngine> engine;
 
   display.setTitle("Game of Life");
   do {
-    welcome(ms);
-    getStartConfig(row, column, worlds);
-    display.setDimensions(row, column);
-    curIdx = 0;
-    drawOnDisp(worlds[curIdx], display);
-    runAnimation(display, worlds, curIdx, ms);
+    welcome(rule, ms);
+    getStartConfig(world, rule);
+    engine = chooseEngine(rule);
+    display.setRenderMode(world.numRows() * world.numCols() > kMaxOvalCells
+                              ? LifeDisplay::PIXEL_BUFFER
+                              : LifeDisplay::OVAL_CELLS);
+    display.setDimensions(world.numRows(), world.numCols());
+    drawOnDisp(world, display);
+    if (engine) {
+      loadEngine(*engine, world);
+    }
+    string recording =
+        trim(getLine("Record this run to a file (blank to skip): "));
+    if (recording.empty()) {
+      runAnimation(display, world, rule, ms, engine.get(), nullptr);
+    } else {
+      ofbitstream out(recording);
+      LifeRecorder recorder(out, world.numRows(), world.numCols(),
+                            kRecordKeyInterval);
+      runAnimation(display, world, rule, ms, engine.get(), &recorder);
+      recorder.finish();
+      cout << "Recorded " << recorder.getFrameCount() << " generations in "
+           << recorder.getBytesWritten() << " bytes." << endl;
+      out.close();
+      replayRecording(display, recording, ms);
+    }
     command = getLine("Exit the game entirely? [Y/N]");
     if (command == "y" || command == "Y") {
       exit_game = true;
@@ -80,13 +151,22 @@ int main() {
   return 0;
 }
 
-static void runAnimation(LifeDisplay &display, vector<Grid<int>> &worlds,
-                         int &curIdx, int ms) {
+static void runAnimation(LifeDisplay &display, LifeWorld &world,
+                         const LifeRule &rule, int ms, LifeEngine *engine,
+                         LifeRecorder *recorder) {
   int pause_time = ms;
   if (ms <= 0) {
     pause_time = 100000;
     cout << "Press any key to evolve" << endl;
   }
+  uint64_t liveHash = engine ? engine->getLiveHash() : hashWorld(world);
+  LifeCycleDetector cycles(kMaxCyclePeriod);
+  cycles.reset(liveHash);
+  LifeBitmap cells;
+  if (recorder) {
+    snapshot(world, cells);
+    recorder->record(cells);
+  }
   GTimer timer(pause_time);
   timer.start();
   while (true) {
@@ -98,12 +178,35 @@ static void runAnimation(LifeDisplay &display, vector<Grid<int>> &worlds,
         getLine();
       }
 
-      evolveWorld(worlds, curIdx);
-      drawOnDisp(worlds[curIdx], display);
-      if (checkStable(worlds, curIdx)) {
+      bool stable;
+      if (engine) {
+        engine->evolve();
+        drawOnDisp(*engine, display);
+        stable = engine->isStable();
+        liveHash = engine->getLiveHash();
+      } else {
+        evolveWorld(world, rule, liveHash);
+        drawOnDisp(world, display);
+        stable = checkStable(world);
+      }
+      if (recorder) {
+        if (engine) {
+          snapshot(*engine, display, cells);
+        } else {
+          snapshot(world, cells);
+        }
+        recorder->record(cells);
+      }
+      if (stable) {
         cout << "Stability reached, quitting!" << endl;
         break;
       }
+      if (cycles.record(liveHash)) {
+        cout << "Period " << cycles.getPeriod()
+             << " oscillation since generation " << cycles.getCycleStart()
+             << ", quitting!" << endl;
+        break;
+      }
     } else if (event.getEventType() == MOUSE_PRESSED) {
       break;
     }
@@ -111,15 +214,16 @@ static void runAnimation(LifeDisplay &display, vector<Grid<int>> &worlds,
   timer.stop();
 }
 
-static bool checkStable(vector<Grid<int>> &worlds, int &curIdx) {
+static bool checkStable(LifeWorld &world) {
   // need to check stability condition, if does not keep aging is still stable
-  int rows = worlds[0].numRows();
-  int cols = worlds[0].numCols();
-  int prevIdx = (curIdx + 1) % 2;
+  int rows = world.numRows();
+  int cols = world.numCols();
   for (int ii = 0; ii < rows; ii++) {
+    const int *cur = world.row(ii);
+    const int *prev = world.backRow(ii); // swapped out by evolveWorld
     for (int jj = 0; jj < cols; jj++) {
-      if (worlds[curIdx][ii][jj] != worlds[prevIdx][ii][jj]) {
-        if (worlds[curIdx][ii][jj] - worlds[prevIdx][ii][jj] != 1) {
+      if (cur[jj] != prev[jj]) {
+        if (cur[jj] - prev[jj] != 1) {
           return false;
         }
       }
@@ -128,86 +232,239 @@ static bool checkStable(vector<Grid<int>> &worlds, int &curIdx) {
   return true;
 }
 
-static int countNeighbours(Grid<int> &world, int &row, int &col) {
-  // all possible rows and columns of a neighbour
-  int row_arr[8] = {row - 1, row - 1, row - 1, row,
-                    row,     row + 1, row + 1, row + 1};
-  int col_arr[8] = {col - 1, col,     col + 1, col - 1,
-                    col + 1, col - 1, col,     col + 1};
-
+static int getNeighbourhood(LifeWorld &world, int row, int col) {
   int rows = world.numRows();
   int cols = world.numCols();
 
-  int neighbours = 0;
-  for (int ii = 0; ii < 8; ii++) {
-    if ((row_arr[ii] >= 0 && row_arr[ii] < rows) &&
-        (col_arr[ii] >= 0 && col_arr[ii] < cols)) {
-      if (world[row_arr[ii]][col_arr[ii]] > 0) {
-        neighbours += 1;
+  // bit 3 * (dr + 1) + (dc + 1) holds the cell at offset (dr, dc)
+  int neighbourhood = 0;
+  for (int dr = -1; dr <= 1; dr++) {
+    for (int dc = -1; dc <= 1; dc++) {
+      int r = row + dr;
+      int c = col + dc;
+      if (r >= 0 && r < rows && c >= 0 && c < cols && world.get(r, c) > 0) {
+        neighbourhood |= 1 << (3 * (dr + 1) + dc + 1);
       }
     }
   }
-  return neighbours;
+  return neighbourhood;
 }
 
-static void evolveWorld(vector<Grid<int>> &worlds, int &curIdx) {
-  int nxtIdx = (curIdx + 1) % 2;
-  int rows = worlds[curIdx].numRows();
-  int cols = worlds[curIdx].numCols();
-  int neighbours = 0;
-  for (int ii = 0; ii < rows; ii++) {
-    for (int jj = 0; jj < cols; jj++) {
-      neighbours = countNeighbours(worlds[curIdx], ii, jj);
-      if (neighbours <= 1) {
-        worlds[nxtIdx][ii][jj] = 0;
-      } else if (neighbours == 2) {
-        if (worlds[curIdx][ii][jj] == 0) {
-          worlds[nxtIdx][ii][jj] = 0;
-        } else {
-          worlds[nxtIdx][ii][jj] = worlds[curIdx][ii][jj] + 1;
+static void getNeighbourhoods(LifeWorld &world) {
+  GridView<const int> cells(world.row(0), world.numRows(), world.numCols(),
+                            world.rowStride());
+  forEachStencil(
+      cells,
+      [&world](int row, int firstCol, int endCol, const int *above,
+               const int *cur, const int *below) {
+        int *out = world.backRow(row);
+        for (int jj = firstCol; jj < endCol; jj++) {
+          out[jj] = (above[jj - 1] > 0) | (above[jj] > 0) << 1 |
+                    (above[jj + 1] > 0) << 2 | (cur[jj - 1] > 0) << 3 |
+                    (cur[jj] > 0) << 4 | (cur[jj + 1] > 0) << 5 |
+                    (below[jj - 1] > 0) << 6 | (below[jj] > 0) << 7 |
+                    (below[jj + 1] > 0) << 8;
         }
-      } else if (neighbours == 3) {
-        // if there were life previously what do I do?
-        if (worlds[curIdx][ii][jj] == 0) {
+      },
+      [&world](int row, int col) {
+        world.backRow(row)[col] = getNeighbourhood(world, row, col);
+      });
+}
 
-          worlds[nxtIdx][ii][jj] = randomInteger(1, kMaxAge);
-        } else {
+static uint64_t hashWorld(LifeWorld &world) {
+  uint64_t hash = 0;
+  for (int ii = 0; ii < world.numRows(); ii++) {
+    for (int jj = 0; jj < world.numCols(); jj++) {
+      if (world.get(ii, jj) > 0) {
+        hash ^= lifeCellKey(ii, jj);
+      }
+    }
+  }
+  return hash;
+}
 
-          worlds[nxtIdx][ii][jj] = worlds[curIdx][ii][jj] + 1;
-        }
+/*
+ * Live cells hold their age and dead cells 0.  Under a Generations rule a
+ * cell that dies counts down through -1, -2, ... to -(states - 2) before
+ * it is empty again; those cells are not alive, so the rule table never
+ * sees them.
+ */
+static void evolveWorld(LifeWorld &world, const LifeRule &rule,
+                        uint64_t &liveHash) {
+  int rows = world.numRows();
+  int cols = world.numCols();
+  const unsigned char *table = rule.getTable();
+  int firstDying = rule.getStates() > 2 ? -1 : 0;
+  int lastDying = 2 - rule.getStates();
+  // the back plane holds each neighbourhood until its cell is replaced
+  getNeighbourhoods(world);
+  for (int ii = 0; ii < rows; ii++) {
+    const int *cur = world.row(ii);
+    int *nxt = world.backRow(ii);
+    for (int jj = 0; jj < cols; jj++) {
+      bool alive = table[nxt[jj]];
+      if (cur[jj] > 0) {
+        nxt[jj] = alive ? min(cur[jj] + 1, kMaxAge) : firstDying;
+      } else if (cur[jj] == 0) {
+        nxt[jj] = alive ? randomInteger(1, kMaxAge) : 0;
       } else {
-        worlds[nxtIdx][ii][jj] = 0;
+        nxt[jj] = cur[jj] > lastDying ? cur[jj] - 1 : 0;
       }
 
-      if (worlds[nxtIdx][ii][jj] > kMaxAge) {
-        worlds[nxtIdx][ii][jj] = kMaxAge;
+      if ((nxt[jj] > 0) != (cur[jj] > 0)) {
+        liveHash ^= lifeCellKey(ii, jj);
       }
     }
   }
-  curIdx = nxtIdx;
+  world.swap();
+}
+
+static void drawOnDisp(LifeWorld &world, LifeDisplay &display) {
+  // dying cells of a Generations rule are drawn in the palest gray
+  display.drawGeneration([&world](int ii, int jj) {
+    int age = world.get(ii, jj);
+    return age < 0 ? kMaxAge : age;
+  });
+  display.repaint();
+}
+
+static void drawOnDisp(LifeEngine &engine, LifeDisplay &display) {
+  int top, left, bottom, right;
+  if (engine.isUnbounded() && engine.getBounds(top, left, bottom, right)) {
+    // the pattern may wander off the starting board, so keep it in view
+    display.followRegion(top, left, bottom, right);
+  }
+  int originRow = display.getViewportRow();
+  int originCol = display.getViewportCol();
+  display.drawGeneration([&](int ii, int jj) {
+    return engine.getAge(originRow + ii, originCol + jj);
+  });
+  display.repaint();
 }
 
-static void drawOnDisp(Grid<int> &world, LifeDisplay &display) {
+static void snapshot(LifeWorld &world, LifeBitmap &cells) {
+  cells.resize(world.numRows(), world.numCols());
+  for (int ii = 0; ii < world.numRows(); ii++) {
+    for (int jj = 0; jj < world.numCols(); jj++) {
+      if (world.get(ii, jj) > 0) {
+        cells.set(ii, jj, true);
+      }
+    }
+  }
+}
+
+static void snapshot(LifeEngine &engine, LifeDisplay &display,
+                     LifeBitmap &cells) {
+  // unbounded engines are recorded through the window the display follows
+  int originRow = display.getViewportRow();
+  int originCol = display.getViewportCol();
+  cells.resize(engine.numRows(), engine.numCols());
+  for (int ii = 0; ii < engine.numRows(); ii++) {
+    for (int jj = 0; jj < engine.numCols(); jj++) {
+      if (engine.getAge(originRow + ii, originCol + jj) > 0) {
+        cells.set(ii, jj, true);
+      }
+    }
+  }
+}
+
+static void replayRecording(LifeDisplay &display, const string &filename,
+                            int ms) {
+  ifbitstream in(filename);
+  LifeReplay replay(in);
+  if (!replay.isValid()) {
+    cout << filename << ": " << replay.getError() << endl;
+    return;
+  }
+  uint64_t frames = replay.getFrameCount();
+  string prompt = "Replay from which generation (0 to " +
+                  to_string(frames - 1) + ", blank to skip)? ";
+  uint64_t generation;
+  while (true) {
+    string start = trim(getLine(prompt));
+    if (start.empty()) {
+      return;
+    }
+    if (stringIsLong(start) && stringToLong(start) >= 0 &&
+        uint64_t(stringToLong(start)) < frames) {
+      generation = uint64_t(stringToLong(start));
+      break;
+    }
+    cout << start << " is not a recorded generation, please try again."
+         << endl;
+  }
+  LifeBitmap cells;
+  display.setDimensions(replay.numRows(), replay.numCols());
+  // recordings only hold liveness, so every live cell is drawn as newborn
+  for (; generation < frames; generation++) {
+    if (!replay.readGeneration(generation, cells)) {
+      cout << filename << ": " << replay.getError() << endl;
+      return;
+    }
+    display.drawGeneration(
+        [&cells](int ii, int jj) { return cells.get(ii, jj) ? 1 : 0; });
+    display.repaint();
+    this_thread::sleep_for(chrono::milliseconds(ms > 0 ? ms : 100));
+  }
+}
+
+static unique_ptr<LifeEngine> chooseEngine(const LifeRule &rule) {
+  string prompt = "Choose a stepping engine [grid";
+  for (const string &name : getLifeEngineNames()) {
+    prompt += "/" + name;
+  }
+  prompt += "], blank for grid: ";
+  while (true) {
+    string name = trim(toLowerCase(getLine(prompt)));
+    if (name.empty() || name == "grid") {
+      return nullptr;
+    }
+    unique_ptr<LifeEngine> engine = createLifeEngine(name);
+    string error;
+    if (!engine) {
+      cout << name << " is not a known engine, please try again." << endl;
+    } else if (!engine->setRule(rule, error)) {
+      cout << "Sorry, " << error << ", please try another." << endl;
+    } else {
+      // same source of birth ages as evolveWorld, so generations match
+      engine->setBirthAgeSource([] { return randomInteger(1, kMaxAge); });
+      return engine;
+    }
+  }
+}
+
+static void loadEngine(LifeEngine &engine, LifeWorld &world) {
   int rows = world.numRows();
   int cols = world.numCols();
+  engine.setDimensions(rows, cols);
   for (int ii = 0; ii < rows; ii++) {
     for (int jj = 0; jj < cols; jj++) {
-      display.drawCellAt(ii, jj, world[ii][jj]);
+      engine.setAge(ii, jj, world.get(ii, jj));
     }
   }
-  display.repaint();
 }
 
-static void welcome(int &ms) {
+static void welcome(LifeRule &rule, int &ms) {
   cout << "Welcome to the game of Life, a simulation of the lifecycle of a "
           "bacteria colony."
        << endl;
-  cout << "Cells live and die by the following rules:" << endl << endl;
-  cout << "\tA cell with 1 or fewer neighbors dies of loneliness" << endl;
-  cout << "\tLocations with 2 neighbors remain stable" << endl;
-  cout << "\tLocations with 3 neighbors will spontaneously create life" << endl;
-  cout << "\tLocations with 4 or more neighbors die of overcrowding" << endl
+  rule = chooseRule();
+  cout << "Under " << rule.toString()
+       << " cells live and die by the following rules:" << endl
        << endl;
+  cout << "\tA cell with " << describeCounts(rule.getSurvivalMask())
+       << " neighbors survives" << endl;
+  cout << "\tAn empty location with " << describeCounts(rule.getBirthMask())
+       << " neighbors will spontaneously create life" << endl;
+  if (rule.getStates() > 2) {
+    cout << "\tAny other cell spends " << rule.getStates() - 2
+         << " generations dying, when it is no neighbor and nothing is born "
+            "in its place"
+         << endl;
+  } else {
+    cout << "\tAny other cell dies, of loneliness or overcrowding" << endl;
+  }
+  cout << endl;
   cout << "In the animation, new cells are dark and fade to gray as they age."
        << endl
        << endl;
@@ -215,58 +472,74 @@ static void welcome(int &ms) {
                     "time to enter manual mode\n"));
 }
 
-static void getStartConfig(int &row, int &column, vector<Grid<int>> &worlds) {
+static LifeRule chooseRule() {
+  while (true) {
+    string spec = trim(getLine("Choose a rule such as B3/S23, B36/S23 or "
+                               "B2/S/C3, blank for B3/S23: "));
+    LifeRule rule;
+    string error;
+    if (spec.empty() || LifeRule::parse(spec, rule, error)) {
+      return rule;
+    }
+    cout << error << ", please try again." << endl;
+  }
+}
+
+static string describeCounts(int mask) {
+  vector<string> counts;
+  for (int n = 0; n <= 8; n++) {
+    if (mask & (1 << n)) {
+      counts.push_back(to_string(n));
+    }
+  }
+  if (counts.empty()) {
+    return "no number of";
+  }
+  string text = counts[0];
+  for (size_t i = 1; i < counts.size(); i++) {
+    text += (i + 1 == counts.size() ? " or " : ", ") + counts[i];
+  }
+  return text;
+}
+
+static void getStartConfig(LifeWorld &world, LifeRule &rule) {
   string filename =
       getLine("Provide a file name that you wish to load config from:");
-  ifstream my_file;
-  my_file.open("files/" + filename);
+  LifeBitmap cells;
+  LifeRule named = rule;
+  string error;
 
-  Grid<int> curWorld, nextWorld;
+  if (!readLifePattern("files/" + filename, cells, named, error)) {
+    cout << error << ", will load random config" << endl;
+    int row = randomInteger(40, 60);
+    int column = randomInteger(40, 60);
 
-  if (!my_file) {
-    cout << filename << " does not exist, will load random config" << endl;
-    row = randomInteger(40, 60);
-    column = randomInteger(40, 60);
-
-    curWorld.resize(row, column);
-    nextWorld.resize(row, column);
+    world.resize(row, column);
 
     for (int ii = 0; ii < row; ii++) {
       for (int jj = 0; jj < column; jj++) {
-        curWorld[ii][jj] = randomInteger(0, 1) * randomInteger(1, kMaxAge);
+        world.set(ii, jj, randomInteger(0, 1) * randomInteger(1, kMaxAge));
       }
     }
   } else {
-    string line;
-    // get column and row info first
-    while (getline(my_file, line)) {
-      if (line[0] != '#') {
-        row = stoi(line);
-        getline(my_file, line);
-        column = stoi(line);
-        break;
-      }
+    if (named != rule) {
+      cout << "This pattern is written for " << named.toString()
+           << ", so it will run under that rule." << endl;
+      rule = named;
     }
-
-    int row_count = 0;
-
-    curWorld.resize(row, column);
-    nextWorld.resize(row, column);
-
-    while (getline(my_file, line)) {
-      for (int column_count = 0; column_count < column; column_count++) {
-        if (line[column_count] == '-') {
-          curWorld[row_count][column_count] = 0;
-        } else {
-          curWorld[row_count][column_count] = 1;
+    world.resize(cells.numRows(), cells.numCols());
+
+    // only visit the live cells; resize already zeroed the rest
+    for (int ii = 0; ii < cells.numRows(); ii++) {
+      const uint64_t *words = cells.row(ii);
+      for (int word = 0; word < cells.wordsPerRow(); word++) {
+        uint64_t live = words[word];
+        while (live != 0) {
+          int bit = __builtin_ctzll(live);
+          live &= live - 1;
+          world.set(ii, word * 64 + bit, 1);
         }
       }
-      row_count += 1;
     }
   }
-
-  worlds.clear();
-  worlds.push_back(curWorld);
-  worlds.push_back(nextWorld);
-  my_file.close();
 }
@@ -0,0 +1,466 @@
+/**
+ * File: maze-bench.cpp
+ * --------------------
+ * Headless benchmarks for the maze generators.
+ *
+ *   maze-bench scaling [--min-dimension D] [--max-dimension D]
+ *                      [--generators a,b,...] [--seed S]
+ *                      [--format csv|json]
+ *
+ * Generates square mazes of dimension D, 2D, 4D, ... up to the maximum
+ * with every listed generator, all of them by default, and prints one
+ * record per maze with the walls removed, walls/second and the peak
+ * resident set size.  Each maze is generated in a child process of its
+ * own, so the peak belongs to that generator alone.
+ *
+ *   maze-bench solve [--min-dimension D] [--max-dimension D]
+ *                    [--generators name] [--solves N] [--seed S]
+ *                    [--format csv|json]
+ *
+ * Generates one square maze of each dimension from D to the maximum,
+ * doubling, with the first listed generator, Kruskal's by default, and
+ * times every solver on the same random start and goal pairs: N of them
+ * on an 8 x 8 maze, and proportionally fewer on larger ones.  Each record
+ * gives solves/second and the mean number of cells expanded per solve.
+ *
+ *   maze-bench eller [--rows R] [--cols C] [--seed S] --output file
+ *
+ * Streams an R x C maze from Eller's generator straight to the file,
+ * which need never fit in memory.  The file starts with the line
+ * "eller-maze <rows> <cols>", followed by one record per row of
+ * (2C - 1 + 7) / 8 bytes: bit c, for c < C - 1, is set if the wall
+ * right of column c is removed, and bit C - 1 + c is set if the wall
+ * below column c is removed, bits counting from the low bit of the
+ * record's first byte.
+ */
+
+#include <sys/resource.h> // for getrusage
+#include <sys/wait.h>     // for waitpid
+#include <unistd.h>       // for fork, pipe
+
+#include <algorithm>
+#include <cctype>  // for isdigit
+#include <cerrno>  // for errno, ERANGE
+#include <chrono>
+#include <climits> // for INT_MAX, INT_MIN
+#include <cstdlib> // for strtol, strtoull
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "maze-eller.h"
+#include "maze-generators.h"
+#include "maze-passages.h"
+#include "maze-solver.h"
+
+struct BenchOptions {
+  int minDimension = 64;
+  int maxDimension = 2048;
+  int rows = 100000;
+  int cols = 1000;
+  int solves = 1000000;
+  uint64_t seed = 106;
+  vector<string> generators;
+  string format = "csv";
+  string output;
+};
+
+static void usage() {
+  cerr << "usage: maze-bench scaling [--min-dimension D] [--max-dimension D]"
+       << endl
+       << "                          [--generators a,b,...] [--seed S]"
+       << " [--format csv|json]" << endl
+       << "       maze-bench solve [--min-dimension D] [--max-dimension D]"
+       << endl
+       << "                        [--generators name] [--solves N]"
+       << " [--seed S] [--format csv|json]" << endl
+       << "       maze-bench eller [--rows R] [--cols C] [--seed S]"
+       << " --output file" << endl;
+}
+
+/*
+ * Each of these stores the whole of value, read as a decimal number, in
+ * result and returns true, or returns false if value holds anything else
+ * or a number out of result's range.
+ */
+static bool parseInt(const string &value, int &result) {
+  char *end;
+  errno = 0;
+  long number = strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || errno == ERANGE || number < INT_MIN ||
+      number > INT_MAX) {
+    return false;
+  }
+  result = int(number);
+  return true;
+}
+
+static bool parseUnsigned(const string &value, uint64_t &result) {
+  char *end;
+  errno = 0;
+  unsigned long long number = strtoull(value.c_str(), &end, 10);
+  if (value.empty() || !isdigit((unsigned char)value[0]) || *end != '\0' ||
+      errno == ERANGE) {
+    return false;
+  }
+  result = number;
+  return true;
+}
+
+static bool parseOptions(int argc, char **argv, int first,
+                         BenchOptions &options) {
+  for (int i = first; i < argc; i++) {
+    string flag = argv[i];
+    if (i + 1 >= argc) {
+      cerr << flag << " needs a value" << endl;
+      return false;
+    }
+    string value = argv[++i];
+    bool number = true;
+    if (flag == "--min-dimension") {
+      number = parseInt(value, options.minDimension);
+    } else if (flag == "--max-dimension") {
+      number = parseInt(value, options.maxDimension);
+    } else if (flag == "--rows") {
+      number = parseInt(value, options.rows);
+    } else if (flag == "--cols") {
+      number = parseInt(value, options.cols);
+    } else if (flag == "--solves") {
+      number = parseInt(value, options.solves);
+    } else if (flag == "--seed") {
+      number = parseUnsigned(value, options.seed);
+    } else if (flag == "--generators") {
+      options.generators.clear();
+      size_t start = 0;
+      while (start <= value.size()) {
+        size_t comma = min(value.find(',', start), value.size());
+        options.generators.push_back(value.substr(start, comma - start));
+        start = comma + 1;
+      }
+    } else if (flag == "--format") {
+      options.format = value;
+    } else if (flag == "--output") {
+      options.output = value;
+    } else {
+      cerr << "unknown option " << flag << endl;
+      return false;
+    }
+    if (!number) {
+      cerr << flag << " needs a number, not " << value << endl;
+      return false;
+    }
+  }
+  return options.minDimension > 0 &&
+         options.maxDimension <= kMaxMazeDimension && options.rows > 0 &&
+         options.cols > 0 && options.solves > 0 &&
+         (options.format == "csv" || options.format == "json");
+}
+
+// peak resident set size of this process so far, in kilobytes
+static long peakResidentKilobytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024; // reported in bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+static string jsonString(const string &text) {
+  string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"' || ch == '\\') {
+      quoted += '\\';
+    }
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+struct ScalingRecord {
+  uint64_t walls;
+  double seconds;
+  long peakKilobytes;
+};
+
+// drains the stream and returns the number of walls it produced
+static uint64_t drain(MazeWallStream &stream) {
+  uint64_t walls = 0;
+  wall w;
+  while (stream.next(w)) {
+    walls++;
+  }
+  return walls;
+}
+
+/*
+ * Generates one maze in a child process and returns its record through
+ * a pipe, or returns false if the child could not be run.
+ */
+static bool measure(const string &name, int dimension, uint64_t seed,
+                    ScalingRecord &record) {
+  int channel[2];
+  if (pipe(channel) != 0) {
+    return false;
+  }
+  pid_t child = fork();
+  if (child < 0) {
+    close(channel[0]);
+    close(channel[1]);
+    return false;
+  }
+  if (child == 0) {
+    close(channel[0]);
+    unique_ptr<MazeGenerator> generator =
+        createMazeGenerator(name, dimension, seed);
+    auto start = chrono::steady_clock::now();
+    ScalingRecord measured;
+    measured.walls = drain(*generator);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    measured.seconds = elapsed.count();
+    measured.peakKilobytes = peakResidentKilobytes();
+    bool sent = write(channel[1], &measured, sizeof(measured)) ==
+                ssize_t(sizeof(measured));
+    _exit(sent ? 0 : 1);
+  }
+  close(channel[1]);
+  bool received =
+      read(channel[0], &record, sizeof(record)) == ssize_t(sizeof(record));
+  close(channel[0]);
+  int status;
+  waitpid(child, &status, 0);
+  return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int runScaling(const BenchOptions &options) {
+  vector<string> generators = options.generators;
+  if (generators.empty()) {
+    generators = getMazeGeneratorNames();
+  }
+  for (const string &name : generators) {
+    if (!createMazeGenerator(name, 1, options.seed)) {
+      cerr << name << " is not a known generator" << endl;
+      return 1;
+    }
+  }
+
+  if (options.format == "csv") {
+    cout << "generator,dimension,walls,seconds,walls_per_sec,peak_rss_kb"
+         << endl;
+  } else {
+    cout << "[" << endl;
+  }
+  bool first = true;
+  int failures = 0;
+  for (int dimension = options.minDimension;
+       dimension <= options.maxDimension; dimension *= 2) {
+    for (const string &name : generators) {
+      ScalingRecord record;
+      if (!measure(name, dimension, options.seed, record)) {
+        cerr << name << " failed at dimension " << dimension << endl;
+        failures++;
+        continue;
+      }
+      if (record.walls != uint64_t(dimension) * dimension - 1) {
+        cerr << name << " removed " << record.walls << " walls at dimension "
+             << dimension << endl;
+        failures++;
+      }
+      double wallsPerSecond = record.walls / max(record.seconds, 1e-9);
+      if (options.format == "csv") {
+        cout << name << "," << dimension << "," << record.walls << ","
+             << fixed << setprecision(6) << record.seconds << ","
+             << scientific << setprecision(4) << wallsPerSecond << ","
+             << record.peakKilobytes << endl;
+      } else {
+        cout << (first ? "  " : ",\n  ")
+             << "{\"generator\": " << jsonString(name)
+             << ", \"dimension\": " << dimension
+             << ", \"walls\": " << record.walls << ", \"seconds\": " << fixed
+             << setprecision(6) << record.seconds
+             << ", \"walls_per_sec\": " << scientific << setprecision(4)
+             << wallsPerSecond
+             << ", \"peak_rss_kb\": " << record.peakKilobytes << "}";
+      }
+      first = false;
+    }
+    if (dimension > options.maxDimension / 2) {
+      break; // doubling again would pass the maximum, or overflow
+    }
+  }
+  if (options.format == "json") {
+    cout << (first ? "]" : "\n]") << endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+static int runSolve(const BenchOptions &options) {
+  string name =
+      options.generators.empty() ? "kruskal" : options.generators[0];
+  if (!createMazeGenerator(name, 1, options.seed)) {
+    cerr << name << " is not a known generator" << endl;
+    return 1;
+  }
+  typedef bool (MazeSolver::*Solve)(cell, cell, vector<cell> &);
+  const string solverNames[] = {"bfs", "astar", "bidirectional"};
+  const Solve solvers[] = {&MazeSolver::solveBreadthFirst,
+                           &MazeSolver::solveAStar,
+                           &MazeSolver::solveBidirectional};
+
+  if (options.format == "csv") {
+    cout << "solver,dimension,solves,seconds,solves_per_sec,mean_expanded"
+         << endl;
+  } else {
+    cout << "[" << endl;
+  }
+  bool first = true;
+  int failures = 0;
+  for (int dimension = options.minDimension;
+       dimension <= options.maxDimension; dimension *= 2) {
+    MazePassages passages(dimension, dimension);
+    unique_ptr<MazeGenerator> generator =
+        createMazeGenerator(name, dimension, options.seed);
+    MazePassageRecorder recorder(*generator, passages);
+    drain(recorder);
+
+    // the same endpoints for every solver, drawn before any timing
+    double scale = 64.0 / (double(dimension) * dimension);
+    int count = max(10, int(options.solves * min(1.0, scale)));
+    mt19937 random(options.seed);
+    uniform_int_distribution<int> coordinate(0, dimension - 1);
+    vector<cell> ends(2 * count);
+    for (cell &end : ends) {
+      end.row = coordinate(random);
+      end.col = coordinate(random);
+    }
+
+    MazeSolver solver(passages);
+    vector<cell> path;
+    path.reserve(size_t(dimension) * dimension);
+    for (int which = 0; which < 3; which++) {
+      (solver.*solvers[which])(ends[0], ends[1], path); // size the scratch
+      uint64_t expanded = 0;
+      auto start = chrono::steady_clock::now();
+      for (int i = 0; i < count; i++) {
+        if (!(solver.*solvers[which])(ends[2 * i], ends[2 * i + 1], path)) {
+          failures++;
+        }
+        expanded += solver.getExpandedCount();
+      }
+      chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+      double seconds = elapsed.count();
+      double solvesPerSecond = count / max(seconds, 1e-9);
+      double meanExpanded = double(expanded) / count;
+      if (options.format == "csv") {
+        cout << solverNames[which] << "," << dimension << "," << count << ","
+             << fixed << setprecision(6) << seconds << "," << scientific
+             << setprecision(4) << solvesPerSecond << "," << fixed
+             << setprecision(1) << meanExpanded << endl;
+      } else {
+        cout << (first ? "  " : ",\n  ")
+             << "{\"solver\": " << jsonString(solverNames[which])
+             << ", \"dimension\": " << dimension << ", \"solves\": " << count
+             << ", \"seconds\": " << fixed << setprecision(6) << seconds
+             << ", \"solves_per_sec\": " << scientific << setprecision(4)
+             << solvesPerSecond << ", \"mean_expanded\": " << fixed
+             << setprecision(1) << meanExpanded << "}";
+      }
+      first = false;
+    }
+    if (dimension > options.maxDimension / 2) {
+      break; // doubling again would pass the maximum, or overflow
+    }
+  }
+  if (options.format == "json") {
+    cout << (first ? "]" : "\n]") << endl;
+  }
+  if (failures > 0) {
+    cerr << failures << " solves found no path" << endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+static int runEller(const BenchOptions &options) {
+  if (options.output.empty()) {
+    cerr << "eller needs --output" << endl;
+    return 1;
+  }
+  ofstream out(options.output.c_str(), ios::binary);
+  if (!out) {
+    cerr << "could not open " << options.output << endl;
+    return 1;
+  }
+  out << "eller-maze " << options.rows << " " << options.cols << "\n";
+
+  int cols = options.cols;
+  size_t recordBytes = (2 * size_t(cols) - 1 + 7) / 8;
+  vector<unsigned char> record(recordBytes, 0);
+  int row = 0;
+  EllerMazeGenerator generator(options.rows, cols, options.seed);
+  auto start = chrono::steady_clock::now();
+  uint64_t walls = 0;
+  wall w;
+  while (generator.next(w)) {
+    // walls come out row by row, so a later row means this one is done
+    while (w.one.row > row) {
+      out.write((const char *)record.data(), recordBytes);
+      record.assign(recordBytes, 0);
+      row++;
+    }
+    size_t bit = w.one.row == w.two.row ? size_t(w.one.col)
+                                        : size_t(cols) - 1 + w.one.col;
+    record[bit / 8] |= (unsigned char)(1 << (bit % 8));
+    walls++;
+  }
+  while (row < options.rows) {
+    out.write((const char *)record.data(), recordBytes);
+    record.assign(recordBytes, 0);
+    row++;
+  }
+  out.close();
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  if (!out) {
+    cerr << "could not write " << options.output << endl;
+    return 1;
+  }
+
+  cout << "maze " << options.rows << "x" << cols << ", " << walls
+       << " walls removed in " << fixed << setprecision(3) << elapsed.count()
+       << " seconds (" << scientific << setprecision(4)
+       << walls / max(elapsed.count(), 1e-9) << " walls/sec)" << endl;
+  cout << "wrote " << uint64_t(options.rows) * recordBytes << " bytes to "
+       << options.output << ", peak resident set "
+       << peakResidentKilobytes() << " KB" << endl;
+  return walls == uint64_t(options.rows) * cols - 1 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+  string mode = argv[1];
+  BenchOptions options;
+  if (!parseOptions(argc, argv, 2, options)) {
+    usage();
+    return 1;
+  }
+  if (mode == "scaling") {
+    return runScaling(options);
+  }
+  if (mode == "solve") {
+    return runSolve(options);
+  }
+  if (mode == "eller") {
+    return runEller(options);
+  }
+  usage();
+  return 1;
+}
@@ -0,0 +1,39 @@
+#####################################################################
+## Headless benchmark for the maze generators                      ##
+#####################################################################
+#
+# Builds a console program that drives the generators in ../src without
+# any graphics, so neither Qt nor the Stanford library is needed:
+#
+#     cd bench && qmake maze-bench.pro && make
+#     ./maze-bench scaling
+#     ./maze-bench solve --max-dimension 256
+#     ./maze-bench eller --cols 1000 --rows 10000000 --output tall.maze
+#
+# Only generator sources belong here; maze-generator.cpp and
+# maze-graphics.cpp need the full Stanford library and are built by
+# maze-generator.pro instead.
+
+TEMPLATE = app
+TARGET = maze-bench
+CONFIG += console c++14
+CONFIG -= qt app_bundle
+
+INCLUDEPATH *= $$PWD/../src/
+
+SOURCES *= $$PWD/maze-bench.cpp
+SOURCES *= $$PWD/../src/maze-backtracker.cpp
+SOURCES *= $$PWD/../src/maze-disjoint-set.cpp
+SOURCES *= $$PWD/../src/maze-eller.cpp
+SOURCES *= $$PWD/../src/maze-generators.cpp
+SOURCES *= $$PWD/../src/maze-kruskal.cpp
+SOURCES *= $$PWD/../src/maze-passages.cpp
+SOURCES *= $$PWD/../src/maze-prim.cpp
+SOURCES *= $$PWD/../src/maze-solver.cpp
+SOURCES *= $$PWD/../src/maze-wilson.cpp
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Wno-sign-compare
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
@@ -0,0 +1,42 @@
+/**
+ * File: maze-backtracker.cpp
+ * --------------------------
+ * Implements the recursive backtracker maze generator.
+ */
+
+#include "maze-backtracker.h"
+
+using namespace std;
+
+BacktrackerMazeGenerator::BacktrackerMazeGenerator(int dimension,
+                                                   uint64_t seed)
+    : MazeGenerator(dimension, dimension), dimension(dimension),
+      visited(uint32_t(dimension) * uint32_t(dimension), 0), random(seed) {
+  uint32_t first = random.below(uint32_t(visited.size()));
+  visited[first] = 1;
+  path.push_back(first);
+}
+
+bool BacktrackerMazeGenerator::next(wall &w) {
+  while (!path.empty()) {
+    uint32_t cell = path.back();
+    uint32_t neighbours[4];
+    int count = mazeNeighbours(dimension, cell, neighbours);
+    int fresh = 0;
+    for (int i = 0; i < count; i++) {
+      if (!visited[neighbours[i]]) {
+        neighbours[fresh++] = neighbours[i];
+      }
+    }
+    if (fresh == 0) {
+      path.pop_back();
+      continue;
+    }
+    uint32_t chosen = neighbours[random.below(fresh)];
+    visited[chosen] = 1;
+    path.push_back(chosen);
+    w = mazeWallBetween(dimension, cell, chosen);
+    return true;
+  }
+  return false;
+}
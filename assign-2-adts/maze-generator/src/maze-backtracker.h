@@ -0,0 +1,46 @@
+/**
+ * File: maze-backtracker.h
+ * ------------------------
+ * Defines a maze generator based on the recursive backtracker: a
+ * depth-first search that moves to a random unvisited neighbour while
+ * it can and backs up when it cannot, giving long winding corridors with
+ * few dead ends.
+ *
+ * The recursion is replaced by an explicit stack of cell indexes, since
+ * the search can be as deep as the maze has cells, far deeper than any
+ * call stack allows.  A maze of n cells costs at most 5 bytes per cell.
+ */
+
+#ifndef _maze_backtracker_
+#define _maze_backtracker_
+
+#include <cstdint>
+#include <vector>
+
+#include "maze-generators.h"
+
+class BacktrackerMazeGenerator : public MazeGenerator {
+public:
+  /**
+   * Prepares a maze of the given dimension, between 1 and
+   * kMaxMazeDimension, with every interior wall standing.  The same seed
+   * always produces the same maze.
+   */
+  BacktrackerMazeGenerator(int dimension, uint64_t seed);
+
+  /**
+   * Stores the next wall to remove and returns true, or returns false
+   * once the maze is complete, after dimension^2 - 1 removals.
+   */
+  bool next(wall &w) override;
+
+  std::string getName() const override { return "backtracker"; }
+
+private:
+  int dimension;
+  std::vector<unsigned char> visited;
+  std::vector<uint32_t> path; // the cells the search is inside, deepest last
+  MazeRandom random;
+};
+
+#endif
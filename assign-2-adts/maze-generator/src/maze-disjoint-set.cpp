@@ -0,0 +1,54 @@
+/**
+ * File: maze-disjoint-set.cpp
+ * ---------------------------
+ * Implements the disjoint-set structure.
+ */
+
+#include "maze-disjoint-set.h"
+
+using namespace std;
+
+DisjointSet::DisjointSet(uint32_t n) : setCount(0) {
+  reset(n);
+}
+
+void DisjointSet::reset(uint32_t n) {
+  parent.resize(n);
+  for (uint32_t i = 0; i < n; i++) {
+    parent[i] = i;
+  }
+  rank.assign(n, 0);
+  setCount = n;
+}
+
+uint32_t DisjointSet::find(uint32_t element) {
+  uint32_t root = element;
+  while (parent[root] != root) {
+    root = parent[root];
+  }
+  // second pass points every element on the path straight at the root
+  while (parent[element] != root) {
+    uint32_t next = parent[element];
+    parent[element] = root;
+    element = next;
+  }
+  return root;
+}
+
+bool DisjointSet::unite(uint32_t one, uint32_t two) {
+  one = find(one);
+  two = find(two);
+  if (one == two) {
+    return false;
+  }
+  if (rank[one] < rank[two]) {
+    parent[one] = two;
+  } else if (rank[one] > rank[two]) {
+    parent[two] = one;
+  } else {
+    parent[two] = one;
+    rank[one]++;
+  }
+  setCount--;
+  return true;
+}
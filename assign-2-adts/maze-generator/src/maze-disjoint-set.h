@@ -0,0 +1,50 @@
+/**
+ * File: maze-disjoint-set.h
+ * -------------------------
+ * Defines a disjoint-set (union-find) structure over the integers
+ * 0 to n - 1.  Finds compress the path they walk and unions attach the
+ * shallower tree under the deeper one, so any sequence of m operations
+ * takes O(m α(n)) time, which is linear for every practical n.
+ */
+
+#ifndef _maze_disjoint_set_
+#define _maze_disjoint_set_
+
+#include <cstdint>
+#include <vector>
+
+class DisjointSet {
+public:
+  /**
+   * Creates n singleton sets, {0} through {n - 1}.
+   */
+  explicit DisjointSet(uint32_t n = 0);
+
+  /**
+   * Resets the structure to n singleton sets, reusing its storage.
+   */
+  void reset(uint32_t n);
+
+  /**
+   * Returns the representative of the set holding element.
+   */
+  uint32_t find(uint32_t element);
+
+  /**
+   * Merges the sets holding one and two.  Returns false if they were
+   * already the same set.
+   */
+  bool unite(uint32_t one, uint32_t two);
+
+  /**
+   * Returns the number of disjoint sets.
+   */
+  uint32_t getSetCount() const { return setCount; }
+
+private:
+  std::vector<uint32_t> parent;
+  std::vector<unsigned char> rank; // at most log2(n), so it fits in a byte
+  uint32_t setCount;
+};
+
+#endif
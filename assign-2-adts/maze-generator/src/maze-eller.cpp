@@ -0,0 +1,91 @@
+/**
+ * File: maze-eller.cpp
+ * --------------------
+ * Implements the Eller maze generator.
+ */
+
+#include "maze-eller.h"
+
+using namespace std;
+
+EllerMazeGenerator::EllerMazeGenerator(int rows, int cols, uint64_t seed)
+    : MazeGenerator(rows, cols), row(0), labels(cols), roots(cols),
+      sizes(cols), keepers(cols), taken(cols), nextPending(0),
+      random(seed) {
+  for (int col = 0; col < cols; col++) {
+    labels[col] = uint32_t(col);
+  }
+}
+
+/*
+ * Fills pending with the walls removed in the current row, then labels
+ * the row below.  Labels are reused once a row no longer holds them, so
+ * cols labels always suffice and a disjoint set over them tracks the
+ * joins within the row.
+ */
+void EllerMazeGenerator::generateRow() {
+  int cols = numCols();
+  bool last = row + 1 == numRows();
+  pending.clear();
+  nextPending = 0;
+  joins.reset(uint32_t(cols));
+  for (int col = 0; col + 1 < cols; col++) {
+    if ((last || random.coin()) && joins.unite(labels[col], labels[col + 1])) {
+      wall w = {{row, col}, {row, col + 1}};
+      pending.push_back(w);
+    }
+  }
+  if (last) {
+    row++;
+    return;
+  }
+
+  // pick the cell that is sure to go down from each chamber uniformly,
+  // by reservoir sampling, then send every other cell down by coin flip
+  for (int col = 0; col < cols; col++) {
+    roots[col] = joins.find(labels[col]);
+    sizes[roots[col]] = 0;
+  }
+  for (int col = 0; col < cols; col++) {
+    uint32_t root = roots[col];
+    if (random.below(++sizes[root]) == 0) {
+      keepers[root] = uint32_t(col);
+    }
+  }
+  taken.assign(cols, 0);
+  for (int col = 0; col < cols; col++) {
+    uint32_t root = roots[col];
+    if (keepers[root] == uint32_t(col) || random.coin()) {
+      wall w = {{row, col}, {row + 1, col}};
+      pending.push_back(w);
+      taken[root] = 1;
+      labels[col] = root;
+    } else {
+      labels[col] = UINT32_MAX;
+    }
+  }
+
+  // cells nothing reached from above start chambers under unused labels
+  uint32_t unused = 0;
+  for (int col = 0; col < cols; col++) {
+    if (labels[col] == UINT32_MAX) {
+      while (taken[unused]) {
+        unused++;
+      }
+      taken[unused] = 1;
+      labels[col] = unused;
+    }
+  }
+  row++;
+}
+
+bool EllerMazeGenerator::next(wall &w) {
+  while (nextPending == pending.size()) {
+    if (row == numRows()) {
+      return false;
+    }
+    generateRow();
+  }
+  w = pending[nextPending++];
+  return true;
+}
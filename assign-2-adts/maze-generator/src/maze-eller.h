@@ -0,0 +1,58 @@
+/**
+ * File: maze-eller.h
+ * ------------------
+ * Defines a maze generator based on Eller's algorithm, which builds the
+ * maze one row at a time and only ever remembers the current row.  Each
+ * cell of the row carries the label of the chamber it belongs to; the
+ * generator randomly joins neighbours in different chambers, then sends
+ * at least one passage down from every chamber, and cells the row below
+ * that no passage reaches start chambers of their own.  The last row
+ * joins every chamber that is left, so the cells form a spanning tree.
+ *
+ * Memory is O(cols) whatever the number of rows, so mazes may be far
+ * taller than would fit in memory as long as their walls are consumed
+ * as they stream out, row by row: first the walls removed between the
+ * cells of a row, then the walls removed below it.
+ */
+
+#ifndef _maze_eller_
+#define _maze_eller_
+
+#include <cstdint>
+#include <vector>
+
+#include "maze-disjoint-set.h"
+#include "maze-generators.h"
+
+class EllerMazeGenerator : public MazeGenerator {
+public:
+  /**
+   * Prepares a rows x cols maze, both positive, with every interior wall
+   * standing.  The same seed always produces the same maze.
+   */
+  EllerMazeGenerator(int rows, int cols, uint64_t seed);
+
+  /**
+   * Stores the next wall to remove and returns true, or returns false
+   * once the maze is complete, after rows * cols - 1 removals.
+   */
+  bool next(wall &w) override;
+
+  std::string getName() const override { return "eller"; }
+
+private:
+  int row;                       // the next row to generate
+  std::vector<uint32_t> labels;  // chamber of each cell in row, < cols
+  std::vector<uint32_t> roots;   // labels after the row's joins
+  std::vector<uint32_t> sizes;   // cells per chamber, by root
+  std::vector<uint32_t> keepers; // the cell sure to go down, by root
+  std::vector<unsigned char> taken;
+  DisjointSet joins;
+  std::vector<wall> pending; // the walls removed in the last row generated
+  size_t nextPending;
+  MazeRandom random;
+
+  void generateRow();
+};
+
+#endif
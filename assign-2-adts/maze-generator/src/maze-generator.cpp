@@ -1,72 +1,102 @@
-/**
- * File: maze-generator.cpp
- * ------------------------
- * Presents an adaptation of Kruskal's algorithm to generate mazes.
- */
-
-#include <iostream>
-using namespace std;
-
-#include "console.h"
-#include "maze-graphics.h"
-#include "set.h"
-#include "simpio.h"
-#include "vector.h"
-
-static int getMazeDimension(string prompt, int minDimension = 7,
-                            int maxDimension = 50) {
-  while (true) {
-    int response = getInteger(prompt);
-    if (response == 0)
-      return response;
-    if (response >= minDimension && response <= maxDimension)
-      return response;
-    cout << "Please enter a number between " << minDimension << " and "
-         << maxDimension << ", inclusive." << endl;
-  }
-}
-
-// static void generate_cells(Vector<cell> &cells, int dim) {
-//   for (int i = 0; i < dim * dim; i++) {
-//     cell aCell = {.row = i / dim, .col = i % dim};
-//     cells.add(aCell);
-//   }
-// }
-
-// static void generate_walls(Vector<wall> &walls, Vector<cell> &cells, int dim) {
-//   for (int i = 0; i < dim - 1; i++) {
-//     for (int j = 0; j < dim; j++) {
-//       wall aWall = {.one = cells[i * dim + j], .two = cells[(i + 1) * dim + j]};
-//       wall bWall = {.one = cells[j * dim + i], .two = cells[j * dim + (i + 1)]};
-//       walls.add(aWall);
-//       walls.add(bWall);
-//     }
-//   }
-// }
-int main() {
-  while (true) {
-    int dimension = getMazeDimension(
-        "What should the dimension of your maze be [0 to exit]? ");
-    if (dimension == 0)
-      break;
-    cout << "This is where I'd animate the construction of a maze of dimension "
-         << dimension << "." << endl;
-    // generate walls
-    MazeGeneratorView mazeView;
-    mazeView.setDimension(dimension);
-
-    // // add walls first time
-    Vector<wall> walls;
-    Vector<cell> cells;
-    generate_cells(cells, dimension);
-    generate_walls(walls, cells, dimension);
-    // ignore two openings?
-    // paint
-    mazeView.repaint();
-    // remove walls iteratively
-    // repaint
-    mazeView.repaint();
-  }
-
-  return 0;
-}
+/**
+ * File: maze-generator.cpp
+ * ------------------------
+ * Generates mazes with a choice of algorithms, Kruskal's by default.
+ */
+
+#include <algorithm> // for find, max
+#include <iostream>
+#include <memory>
+#include <random>    // for random_device
+#include <vector>
+using namespace std;
+
+#include "console.h"
+#include "maze-generators.h" // for createMazeGenerator
+#include "maze-graphics.h"
+#include "maze-passages.h" // for MazePassages, MazePassageRecorder
+#include "maze-solver.h"   // for MazeSolver
+#include "maze-walls.h" // for mazeWall, mazeWallCount
+#include "simpio.h"
+#include "strlib.h" // for trim, toLowerCase
+
+// the view draws every wall as its own line, which bounds the dimension
+// long before the generator does
+static const int kMaxDimension = 500;
+
+// the removals are spread over this many repaints whatever the dimension
+static const int kAnimationFrames = 250;
+
+static int getMazeDimension(string prompt, int minDimension = 7,
+                            int maxDimension = kMaxDimension) {
+  while (true) {
+    int response = getInteger(prompt);
+    if (response == 0)
+      return response;
+    if (response >= minDimension && response <= maxDimension)
+      return response;
+    cout << "Please enter a number between " << minDimension << " and "
+         << maxDimension << ", inclusive." << endl;
+  }
+}
+
+static string getGeneratorName() {
+  vector<string> names = getMazeGeneratorNames();
+  string listing;
+  for (const string &name : names) {
+    listing += (listing.empty() ? "" : ", ") + name;
+  }
+  while (true) {
+    string response = toLowerCase(
+        trim(getLine("Which algorithm should build it (" + listing +
+                     ") [" + names[0] + "]? ")));
+    if (response.empty())
+      return names[0];
+    if (find(names.begin(), names.end(), response) != names.end())
+      return response;
+    cout << "Please enter one of " << listing << "." << endl;
+  }
+}
+
+int main() {
+  while (true) {
+    int dimension = getMazeDimension(
+        "What should the dimension of your maze be [0 to exit]? ");
+    if (dimension == 0)
+      break;
+    string name = getGeneratorName();
+    MazeGeneratorView mazeView;
+    mazeView.setDimension(dimension);
+
+    // every interior wall stands at first
+    vector<wall> walls(mazeWallCount(dimension));
+    for (uint32_t id = 0; id < walls.size(); id++) {
+      walls[id] = mazeWall(dimension, id);
+    }
+    mazeView.addAllWalls(walls);
+    mazeView.repaint();
+
+    // remove walls as the generator produces them
+    unique_ptr<MazeGenerator> generator =
+        createMazeGenerator(name, dimension, random_device()());
+    MazePassages passages(dimension, dimension);
+    MazePassageRecorder recorder(*generator, passages);
+    int batch = max(1, (dimension * dimension - 1) / kAnimationFrames);
+    while (mazeView.removeWalls(recorder, batch) > 0) {
+      mazeView.repaint();
+    }
+
+    // the border opens at the upper-left and lower-right corners
+    MazeSolver solver(passages);
+    vector<cell> path;
+    cell entrance = {0, 0}, wayOut = {dimension - 1, dimension - 1};
+    if (solver.solveBidirectional(entrance, wayOut, path)) {
+      mazeView.drawPath(path);
+      mazeView.repaint();
+      cout << "The way through takes " << path.size() - 1 << " steps."
+           << endl;
+    }
+  }
+
+  return 0;
+}
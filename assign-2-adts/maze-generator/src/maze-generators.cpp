@@ -0,0 +1,41 @@
+/**
+ * File: maze-generators.cpp
+ * -------------------------
+ * Implements the maze generator factory.
+ */
+
+#include "maze-generators.h"
+
+#include "maze-backtracker.h"
+#include "maze-eller.h"
+#include "maze-kruskal.h"
+#include "maze-prim.h"
+#include "maze-wilson.h"
+using namespace std;
+
+unique_ptr<MazeGenerator> createMazeGenerator(const string &name,
+                                              int dimension, uint64_t seed) {
+  if (name == "kruskal") {
+    return unique_ptr<MazeGenerator>(
+        new KruskalMazeGenerator(dimension, seed));
+  }
+  if (name == "wilson") {
+    return unique_ptr<MazeGenerator>(new WilsonMazeGenerator(dimension, seed));
+  }
+  if (name == "backtracker") {
+    return unique_ptr<MazeGenerator>(
+        new BacktrackerMazeGenerator(dimension, seed));
+  }
+  if (name == "prim") {
+    return unique_ptr<MazeGenerator>(new PrimMazeGenerator(dimension, seed));
+  }
+  if (name == "eller") {
+    return unique_ptr<MazeGenerator>(
+        new EllerMazeGenerator(dimension, dimension, seed));
+  }
+  return nullptr;
+}
+
+vector<string> getMazeGeneratorNames() {
+  return {"kruskal", "wilson", "backtracker", "prim", "eller"};
+}
@@ -0,0 +1,100 @@
+/**
+ * File: maze-generators.h
+ * -----------------------
+ * Defines the interface shared by the maze generation algorithms, along
+ * with a factory that builds one by name so the algorithm can be chosen
+ * at runtime.  Every generator is a MazeWallStream: it starts from a maze
+ * with every interior wall standing and hands back, one at a time, the
+ * walls to remove so that the cells form a spanning tree.  Generators
+ * only depend on the standard library, so they can also be driven
+ * without any graphics.
+ */
+
+#ifndef _maze_generators_
+#define _maze_generators_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "maze-walls.h"
+
+class MazeGenerator : public MazeWallStream {
+public:
+  /**
+   * Returns the name the generator is registered under in
+   * createMazeGenerator.
+   */
+  virtual std::string getName() const = 0;
+
+  int numRows() const { return rows; }
+  int numCols() const { return cols; }
+
+protected:
+  MazeGenerator(int rows, int cols) : rows(rows), cols(cols) {}
+
+private:
+  int rows;
+  int cols;
+
+  MazeGenerator(const MazeGenerator &original);
+  void operator=(const MazeGenerator &rhs) const;
+};
+
+/**
+ * Class: MazeRandom
+ * -----------------
+ * The random source the generators share.  Coin flips are served from a
+ * buffered 64-bit draw, since most generators flip far more coins than
+ * they pick from ranges.
+ */
+class MazeRandom {
+public:
+  explicit MazeRandom(uint64_t seed) : engine(seed), bits(0), bitsLeft(0) {}
+
+  bool coin() {
+    if (bitsLeft == 0) {
+      bits = engine();
+      bitsLeft = 64;
+    }
+    bool heads = bits & 1;
+    bits >>= 1;
+    bitsLeft--;
+    return heads;
+  }
+
+  /**
+   * Returns a value drawn uniformly from [0, n), n being positive.
+   */
+  uint32_t below(uint32_t n) {
+    return std::uniform_int_distribution<uint32_t>(0, n - 1)(engine);
+  }
+
+private:
+  std::mt19937_64 engine;
+  uint64_t bits;
+  int bitsLeft;
+};
+
+/**
+ * Function: createMazeGenerator
+ * -----------------------------
+ * Builds the generator registered under the given name for a square maze
+ * of the given dimension, between 1 and kMaxMazeDimension, or returns
+ * nullptr if no generator has that name.  The same seed always produces
+ * the same maze.
+ */
+std::unique_ptr<MazeGenerator> createMazeGenerator(const std::string &name,
+                                                   int dimension,
+                                                   uint64_t seed);
+
+/**
+ * Function: getMazeGeneratorNames
+ * -------------------------------
+ * Returns the names accepted by createMazeGenerator.
+ */
+std::vector<std::string> getMazeGeneratorNames();
+
+#endif
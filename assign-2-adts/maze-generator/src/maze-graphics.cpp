@@ -9,6 +9,7 @@
 #include "maze-graphics.h"
 
 #include <string>
+#include <utility> // for swap
 using namespace std;
 
 /**
@@ -21,6 +22,7 @@ static const double kWindowWidth = 14 * 72; // 14 inches at 72 pixel per inch
 static const double kWindowHeight = 8 * 72; // 8 inches at 72 pixels per inch
 static const string kMazeVisibleColor("Blue");
 static const string kMazeInvisibleColor("White");
+static const string kMazePathColor("Red");
 static const double kMazeSize = 7 * 72; // 7 inches at 72 pixels per inch
 static const double kLineWidth = 2.0;
 static const double kEndSegmentFraction = 0.25;
@@ -41,24 +43,48 @@ MazeGeneratorView::~MazeGeneratorView() {
 void MazeGeneratorView::setDimension(int dimension) {
     if (dimension <= 0)
         error("Value passed to MazeGeneratorView::setDimension should be positive.");
-    
+    if (dimension > kMaxMazeDimension)
+        error("Value passed to MazeGeneratorView::setDimension is too large.");
+
     setColor("White");
     fillRect(0, 0, getWidth(), getHeight());
     this->dimension = dimension;
     wallLength = kMazeSize / dimension;
-    wallLines.clear();
+    wallLines.assign(mazeWallCount(dimension), nullptr);
+    pathLines.clear();
     clear();
     drawBorder();
 }
 
+/**
+ * Returns the ID of the wall between two adjacent cells, given in either
+ * order, so that its line can be found without any searching.
+ */
+uint32_t MazeGeneratorView::wallIndex(const wall& w) const {
+    cell first = w.one, second = w.two;
+    if (second < first) {
+        swap(first, second);
+    }
+    bool across = first.row == second.row && first.col + 1 == second.col;
+    bool down = first.col == second.col && first.row + 1 == second.row;
+    if ((!across && !down) || first.row < 0 || first.col < 0 ||
+        second.row >= dimension || second.col >= dimension) {
+        error("Wall passed to MazeGeneratorView doesn't separate two adjacent cells of the maze.");
+    }
+    wall ordered = { first, second };
+    return mazeWallId(dimension, ordered);
+}
+
 void MazeGeneratorView::addOneWall(const wall& w, const string& color, double inset) {
-    if (wallLines.containsKey(w)) {
+    uint32_t index = wallIndex(w);
+    GLine*& line = wallLines[index];
+    if (line != nullptr) {
         // then we just need to recolor the wall's center segment
-        wallLines[w]->setColor(color);
+        line->setColor(color);
     } else {
-        
-        double startx = ulx + w.one.col * this->wallLength;
-        double starty = uly + w.one.row * this->wallLength;
+        wall ordered = mazeWall(dimension, index);
+        double startx = ulx + ordered.one.col * this->wallLength;
+        double starty = uly + ordered.one.row * this->wallLength;
         
         double wallLength = this->wallLength;
         if (color == kMazeInvisibleColor) {
@@ -69,7 +95,7 @@ void MazeGeneratorView::addOneWall(const wall& w, const string& color, double in
         GLine* firstBit;
         GLine* lastBit;
         
-        if (w.one.row == w.two.row) { // horizontal wall
+        if (ordered.one.row == ordered.two.row) { // horizontal wall
             startx += this->wallLength;
             starty += inset;
             // have a little overlap between center segment and end segments
@@ -102,7 +128,7 @@ void MazeGeneratorView::addOneWall(const wall& w, const string& color, double in
         // insert mutable wall
         wallLine->setColor(color);
         wallLine->setLineWidth(kLineWidth);
-        wallLines.put(w, wallLine);
+        line = wallLine;
         add(wallLine);
     }
 }
@@ -134,8 +160,58 @@ void MazeGeneratorView::addOneWall(const wall& w) {
     addOneWall(w, kMazeVisibleColor, 0);
 }
 
+void MazeGeneratorView::removeOneWall(const wall& w) {
+    // not wrapped within Qt Gui thread here because it's called from
+    // removeWall and removeWalls, which already do that
+    addOneWall(w, kMazeInvisibleColor, wallLength / 5);
+}
+
 void MazeGeneratorView::removeWall(const wall& w) {
     GThread::runOnQtGuiThread([&] {
-        addOneWall(w, kMazeInvisibleColor, wallLength / 5);
+        removeOneWall(w);
+    });
+}
+
+void MazeGeneratorView::drawPath(const vector<cell>& path) {
+    GThread::runOnQtGuiThread([&] {
+        for (GLine* line : pathLines) {
+            remove(line);
+            delete line;
+        }
+        pathLines.clear();
+
+        // one line per straight run of the path rather than one per step
+        size_t start = 0;
+        while (start + 1 < path.size()) {
+            size_t end = start + 1;
+            int drow = path[end].row - path[start].row;
+            int dcol = path[end].col - path[start].col;
+            while (end + 1 < path.size() &&
+                   path[end + 1].row - path[end].row == drow &&
+                   path[end + 1].col - path[end].col == dcol) {
+                end++;
+            }
+            GLine* line = new GLine(ulx + (path[start].col + 0.5) * wallLength,
+                                    uly + (path[start].row + 0.5) * wallLength,
+                                    ulx + (path[end].col + 0.5) * wallLength,
+                                    uly + (path[end].row + 0.5) * wallLength);
+            line->setColor(kMazePathColor);
+            line->setLineWidth(kLineWidth);
+            add(line);
+            pathLines.push_back(line);
+            start = end;
+        }
+    });
+}
+
+int MazeGeneratorView::removeWalls(MazeWallStream& stream, int maxWalls) {
+    int removed = 0;
+    GThread::runOnQtGuiThread([&] {
+        wall w;
+        while (removed < maxWalls && stream.next(w)) {
+            removeOneWall(w);
+            removed++;
+        }
     });
+    return removed;
 }
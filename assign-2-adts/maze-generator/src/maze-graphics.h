@@ -9,8 +9,10 @@
 #define _maze_graphics_
 
 #include <string>
+#include <vector>
 #include "gwindow.h"
 #include "maze-types.h"
+#include "maze-walls.h"
 #include "gthread.h"
 
 class MazeGeneratorView : private GWindow {
@@ -78,6 +80,41 @@ public:
  */
     void removeWall(const wall& w);
 
+/**
+ * Method: removeWalls
+ * -------------------
+ * Removes all the previously drawn walls contained within the parameter,
+ * all in one trip to the Qt Gui thread, so it's much faster than several
+ * sequential calls to removeWall.
+ * To update the display to reflect new removals, call view.repaint();
+ *
+ * This function requires that the parameter passed in is, in fact, a collection
+ * that can be iterated through and that contains wall objects.
+ */
+    template <typename C>
+    void removeWalls(const C& collection) { removeWalls(collection.begin(), collection.end()); }
+    // defined inline as required by template type
+
+/**
+ * Method: removeWalls
+ * -------------------
+ * Draws up to maxWalls walls from the stream and removes each of them,
+ * all in one trip to the Qt Gui thread.  Returns how many walls were
+ * removed, which is less than maxWalls only once the stream is exhausted.
+ * To update the display to reflect new removals, call view.repaint();
+ */
+    int removeWalls(MazeWallStream& stream, int maxWalls);
+
+/**
+ * Method: drawPath
+ * ----------------
+ * Highlights a path through the maze, given as a sequence of cells each
+ * next to the one before, with a line through the cells' centers.  Any
+ * path drawn before is erased first, all in one trip to the Qt Gui thread.
+ * To display the path on the screen, call view.repaint();
+ */
+    void drawPath(const std::vector<cell>& path);
+
 /**
  * Method: repaint
  * ---------------
@@ -92,9 +129,14 @@ private:
     double ulx;
     double uly;
 
-    Map<wall, GLine*> wallLines;
+    // the recolorable center segment of each wall, indexed by wall ID as
+    // numbered in maze-walls.h, or nullptr until the wall is first added
+    std::vector<GLine*> wallLines;
+    std::vector<GLine*> pathLines;
 
+    uint32_t wallIndex(const wall& w) const;
     void addOneWall(const wall& w, const std::string& color, double inset);
+    void removeOneWall(const wall& w);
     void drawColoredLine(double startx, double starty, double endx, double endy, const std::string& color);
 
     // optimize addAllWalls for speed by using the QtGui thread
@@ -106,6 +148,15 @@ private:
             }
         });
     }
+
+    template <typename ForwardIterator>
+    void removeWalls(ForwardIterator start, ForwardIterator end) {
+        GThread::runOnQtGuiThread([&] {
+            for(; start != end; ++start) {
+                removeOneWall(*start);
+            }
+        });
+    }
 };
 
 #endif
@@ -0,0 +1,43 @@
+/**
+ * File: maze-kruskal.cpp
+ * ----------------------
+ * Implements the Kruskal maze generator.
+ */
+
+#include "maze-kruskal.h"
+
+#include <utility> // for swap
+using namespace std;
+
+KruskalMazeGenerator::KruskalMazeGenerator(int dimension, uint64_t seed)
+    : MazeGenerator(dimension, dimension), dimension(dimension),
+      considered(0), removed(0),
+      chambers(uint32_t(dimension) * uint32_t(dimension)), random(seed) {
+  uint32_t count = mazeWallCount(dimension);
+  walls.resize(count);
+  for (uint32_t id = 0; id < count; id++) {
+    walls[id] = id;
+  }
+}
+
+/*
+ * Draws walls by a Fisher-Yates shuffle done one step at a time, so the
+ * walls left over once the maze is connected are never shuffled.
+ */
+bool KruskalMazeGenerator::next(wall &w) {
+  uint32_t cells = uint32_t(dimension) * uint32_t(dimension);
+  uint32_t count = uint32_t(walls.size());
+  while (removed + 1 < cells && considered < count) {
+    uniform_int_distribution<uint32_t> pick(considered, count - 1);
+    swap(walls[considered], walls[pick(random)]);
+    uint32_t candidate = walls[considered++];
+    uint32_t first, second;
+    mazeWallCells(dimension, candidate, first, second);
+    if (chambers.unite(first, second)) {
+      removed++;
+      w = mazeWall(dimension, candidate);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,55 @@
+/**
+ * File: maze-kruskal.h
+ * --------------------
+ * Defines a maze generator based on Kruskal's algorithm: every cell
+ * starts in its own chamber, and walls are considered in random order,
+ * each one removed if the cells on either side are not yet connected.
+ * The result is a spanning tree of the cells, so exactly one path joins
+ * any two of them.
+ *
+ * Walls are shuffled lazily as they are drawn, chambers are tracked with
+ * a disjoint-set structure, and generation stops as soon as the last
+ * chamber is merged, so a maze of n cells costs near-linear time and
+ * 4 bytes per wall plus 5 bytes per cell.
+ */
+
+#ifndef _maze_kruskal_
+#define _maze_kruskal_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "maze-disjoint-set.h"
+#include "maze-generators.h"
+
+class KruskalMazeGenerator : public MazeGenerator {
+public:
+  /**
+   * Prepares a maze of the given dimension, between 1 and
+   * kMaxMazeDimension, with every interior wall standing.  The same seed
+   * always produces the same maze.
+   */
+  KruskalMazeGenerator(int dimension, uint64_t seed);
+
+  /**
+   * Stores the next wall to remove and returns true, or returns false
+   * once the maze is complete, after dimension^2 - 1 removals.
+   */
+  bool next(wall &w) override;
+
+  std::string getName() const override { return "kruskal"; }
+
+private:
+  int dimension;
+  std::vector<uint32_t> walls; // walls[considered...] are still unseen
+  uint32_t considered;
+  uint32_t removed;
+  DisjointSet chambers;
+  std::mt19937_64 random;
+
+  KruskalMazeGenerator(const KruskalMazeGenerator &original);
+  void operator=(const KruskalMazeGenerator &rhs) const;
+};
+
+#endif
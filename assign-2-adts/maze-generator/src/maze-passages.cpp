@@ -0,0 +1,37 @@
+/**
+ * File: maze-passages.cpp
+ * -----------------------
+ * Implements the compact passage record.
+ */
+
+#include "maze-passages.h"
+
+using namespace std;
+
+MazePassages::MazePassages(int rows, int cols) {
+  reset(rows, cols);
+}
+
+void MazePassages::reset(int rows, int cols) {
+  this->rows = rows;
+  this->cols = cols;
+  bits.assign((uint64_t(rows) * uint64_t(cols) + 31) / 32, 0);
+}
+
+// the bit recording the wall, which belongs to its upper or left cell
+uint64_t MazePassages::bitIndex(const wall &w) const {
+  const cell &first = w.two < w.one ? w.two : w.one;
+  uint64_t index = uint64_t(first.row) * uint64_t(cols) + uint64_t(first.col);
+  bool down = w.one.col == w.two.col;
+  return index * 2 + (down ? 1 : 0);
+}
+
+void MazePassages::open(const wall &w) {
+  uint64_t bit = bitIndex(w);
+  bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+}
+
+bool MazePassages::isOpen(const wall &w) const {
+  uint64_t bit = bitIndex(w);
+  return (bits[bit >> 6] >> (bit & 63)) & 1;
+}
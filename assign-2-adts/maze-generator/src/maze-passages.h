@@ -0,0 +1,91 @@
+/**
+ * File: maze-passages.h
+ * ---------------------
+ * Defines a compact record of which walls of a rows x cols maze have
+ * been removed, so that a generated maze can be solved without keeping
+ * the list of walls around.  Each cell has 2 bits, one for the passage
+ * to its right and one for the passage below it, so a million-cell maze
+ * takes 250KB.
+ */
+
+#ifndef _maze_passages_
+#define _maze_passages_
+
+#include <cstdint>
+#include <vector>
+
+#include "maze-types.h"
+#include "maze-walls.h"
+
+class MazePassages {
+public:
+  /**
+   * Creates a rows x cols maze with every interior wall standing.
+   */
+  MazePassages(int rows = 0, int cols = 0);
+
+  /**
+   * Resizes the maze to rows x cols and puts every interior wall back.
+   */
+  void reset(int rows, int cols);
+
+  int numRows() const { return rows; }
+  int numCols() const { return cols; }
+
+  /**
+   * Removes the wall between two adjacent cells, given in either order.
+   */
+  void open(const wall &w);
+
+  /**
+   * Returns true if the wall between two adjacent cells, given in either
+   * order, has been removed.
+   */
+  bool isOpen(const wall &w) const;
+
+  /**
+   * Returns the two bits of the cell with the given index, row * cols +
+   * col: kOpenRight is set if the passage to its right is open, and
+   * kOpenDown if the passage below it is.
+   */
+  unsigned passages(uint32_t cell) const {
+    return unsigned(bits[cell >> 5] >> ((cell & 31) * 2)) & 3;
+  }
+
+  static const unsigned kOpenRight = 1;
+  static const unsigned kOpenDown = 2;
+
+private:
+  int rows;
+  int cols;
+  std::vector<uint64_t> bits; // 32 cells per word
+
+  uint64_t bitIndex(const wall &w) const;
+};
+
+/**
+ * Class: MazePassageRecorder
+ * --------------------------
+ * Passes walls through from another stream, opening each one in a
+ * MazePassages as it goes by, so a maze can be recorded while it is
+ * being drawn.
+ */
+class MazePassageRecorder : public MazeWallStream {
+public:
+  MazePassageRecorder(MazeWallStream &source, MazePassages &passages)
+      : source(source), passages(passages) {}
+
+  bool next(wall &w) override {
+    if (!source.next(w)) {
+      return false;
+    }
+    passages.open(w);
+    return true;
+  }
+
+private:
+  MazeWallStream &source;
+  MazePassages &passages;
+};
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * File: maze-prim.cpp
+ * -------------------
+ * Implements the Prim maze generator.
+ */
+
+#include "maze-prim.h"
+
+#include <utility> // for swap
+using namespace std;
+
+enum { kOutside, kFrontier, kInside };
+
+PrimMazeGenerator::PrimMazeGenerator(int dimension, uint64_t seed)
+    : MazeGenerator(dimension, dimension), dimension(dimension),
+      state(uint32_t(dimension) * uint32_t(dimension), kOutside),
+      random(seed) {
+  admit(random.below(uint32_t(state.size())));
+}
+
+// moves cell into the maze and its outside neighbours onto the frontier
+void PrimMazeGenerator::admit(uint32_t cell) {
+  state[cell] = kInside;
+  uint32_t neighbours[4];
+  int count = mazeNeighbours(dimension, cell, neighbours);
+  for (int i = 0; i < count; i++) {
+    if (state[neighbours[i]] == kOutside) {
+      state[neighbours[i]] = kFrontier;
+      frontier.push_back(neighbours[i]);
+    }
+  }
+}
+
+bool PrimMazeGenerator::next(wall &w) {
+  if (frontier.empty()) {
+    return false;
+  }
+  swap(frontier[random.below(uint32_t(frontier.size()))], frontier.back());
+  uint32_t cell = frontier.back();
+  frontier.pop_back();
+
+  uint32_t neighbours[4];
+  int count = mazeNeighbours(dimension, cell, neighbours);
+  int inside = 0;
+  for (int i = 0; i < count; i++) {
+    if (state[neighbours[i]] == kInside) {
+      neighbours[inside++] = neighbours[i];
+    }
+  }
+  w = mazeWallBetween(dimension, cell, neighbours[random.below(inside)]);
+  admit(cell);
+  return true;
+}
@@ -0,0 +1,48 @@
+/**
+ * File: maze-prim.h
+ * -----------------
+ * Defines a maze generator based on Prim's algorithm with random
+ * weights: the maze grows from one cell, and each step picks a random
+ * cell on its frontier and joins it to a random neighbour already in the
+ * maze, giving short passages that branch often.
+ *
+ * The frontier is an unordered array, so a random cell is picked and
+ * removed in constant time.  A maze of n cells costs at most 5 bytes per
+ * cell.
+ */
+
+#ifndef _maze_prim_
+#define _maze_prim_
+
+#include <cstdint>
+#include <vector>
+
+#include "maze-generators.h"
+
+class PrimMazeGenerator : public MazeGenerator {
+public:
+  /**
+   * Prepares a maze of the given dimension, between 1 and
+   * kMaxMazeDimension, with every interior wall standing.  The same seed
+   * always produces the same maze.
+   */
+  PrimMazeGenerator(int dimension, uint64_t seed);
+
+  /**
+   * Stores the next wall to remove and returns true, or returns false
+   * once the maze is complete, after dimension^2 - 1 removals.
+   */
+  bool next(wall &w) override;
+
+  std::string getName() const override { return "prim"; }
+
+private:
+  int dimension;
+  std::vector<unsigned char> state; // kOutside, kFrontier or kInside
+  std::vector<uint32_t> frontier;
+  MazeRandom random;
+
+  void admit(uint32_t cell);
+};
+
+#endif
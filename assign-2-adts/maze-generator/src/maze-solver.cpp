@@ -0,0 +1,305 @@
+/**
+ * File: maze-solver.cpp
+ * ---------------------
+ * Implements the maze solver.
+ */
+
+#include "maze-solver.h"
+
+#include <algorithm>  // for push_heap, pop_heap, reverse
+#include <cstdlib>    // for abs
+#include <functional> // for greater
+using namespace std;
+
+// directions, numbered so that the opposite of d is 3 - d
+enum { kUp, kLeft, kRight, kDown, kRoot };
+
+MazeSolver::MazeSolver(const MazePassages &maze)
+    : maze(maze), cols(0), cells(0), stamp(0), expanded(0) {}
+
+/*
+ * Resizes the scratch space if the maze has changed size, starts a new
+ * stamp and checks the endpoints.  Returns false if either endpoint lies
+ * outside the maze.
+ */
+bool MazeSolver::begin(cell start, cell goal, uint32_t &from, uint32_t &to,
+                       vector<cell> &path) {
+  path.clear();
+  expanded = 0;
+  uint32_t size = uint32_t(maze.numRows()) * uint32_t(maze.numCols());
+  if (size != cells || uint32_t(maze.numCols()) != cols) {
+    cols = uint32_t(maze.numCols());
+    cells = size;
+    seen.assign(cells, 0);
+    parent.resize(cells);
+    distance.resize(cells);
+    queue.resize(cells);
+    stamp = 0;
+  }
+  // bidirectional searches use stamp and stamp + 1, so stamps step by 2
+  stamp += 2;
+  if (stamp == 0) {
+    seen.assign(cells, 0);
+    stamp = 2;
+  }
+  if (start.row < 0 || start.row >= maze.numRows() || start.col < 0 ||
+      start.col >= maze.numCols() || goal.row < 0 ||
+      goal.row >= maze.numRows() || goal.col < 0 ||
+      goal.col >= maze.numCols()) {
+    return false;
+  }
+  from = uint32_t(start.row) * cols + uint32_t(start.col);
+  to = uint32_t(goal.row) * cols + uint32_t(goal.col);
+  return true;
+}
+
+/*
+ * Stores the cells one step from index through open passages, along
+ * with the direction that leads back from each, and returns how many
+ * there are.  No passage leads right from the last column, so the cell
+ * before index only opens into it from the same row, and no division is
+ * needed to find the column.
+ */
+int MazeSolver::moves(uint32_t index, uint32_t reached[4],
+                      unsigned char back[4]) const {
+  int count = 0;
+  unsigned here = maze.passages(index);
+  if (index >= cols &&
+      (maze.passages(index - cols) & MazePassages::kOpenDown)) {
+    reached[count] = index - cols;
+    back[count++] = kDown;
+  }
+  if (index > 0 && (maze.passages(index - 1) & MazePassages::kOpenRight)) {
+    reached[count] = index - 1;
+    back[count++] = kRight;
+  }
+  if (here & MazePassages::kOpenRight) {
+    reached[count] = index + 1;
+    back[count++] = kLeft;
+  }
+  if (here & MazePassages::kOpenDown) {
+    reached[count] = index + cols;
+    back[count++] = kUp;
+  }
+  return count;
+}
+
+uint32_t MazeSolver::step(uint32_t index, unsigned char direction) const {
+  switch (direction) {
+  case kUp:
+    return index - cols;
+  case kLeft:
+    return index - 1;
+  case kRight:
+    return index + 1;
+  default:
+    return index + cols;
+  }
+}
+
+/*
+ * Writes the cells from index back to the root of its search, working
+ * backwards from end, which must leave room for distance[index] + 1
+ * cells.
+ */
+void MazeSolver::trace(uint32_t index, cell *end) const {
+  while (true) {
+    --end;
+    end->row = int(index / cols);
+    end->col = int(index % cols);
+    if (parent[index] == kRoot) {
+      return;
+    }
+    index = step(index, parent[index]);
+  }
+}
+
+
+bool MazeSolver::solveBreadthFirst(cell start, cell goal,
+                                   vector<cell> &path) {
+  uint32_t from, to;
+  if (!begin(start, goal, from, to, path)) {
+    return false;
+  }
+  seen[from] = stamp;
+  parent[from] = kRoot;
+  distance[from] = 0;
+  queue[0] = from;
+  uint32_t head = 0, tail = 1;
+  while (head < tail) {
+    uint32_t index = queue[head++];
+    expanded++;
+    if (index == to) {
+      path.resize(distance[to] + 1);
+      trace(to, path.data() + path.size());
+      return true;
+    }
+    uint32_t reached[4];
+    unsigned char back[4];
+    int count = moves(index, reached, back);
+    for (int i = 0; i < count; i++) {
+      uint32_t next = reached[i];
+      if (seen[next] != stamp) {
+        seen[next] = stamp;
+        parent[next] = back[i];
+        distance[next] = distance[index] + 1;
+        queue[tail++] = next;
+      }
+    }
+  }
+  return false;
+}
+
+/*
+ * The Manhattan distance never overestimates and changes by at most one
+ * per step, so the first time a cell is expanded its distance is final
+ * and stale heap entries can simply be skipped.  Every cell is expanded
+ * at most once and pushed at most once per open passage, so reserving
+ * 4 entries per cell means the heap never reallocates.
+ */
+bool MazeSolver::solveAStar(cell start, cell goal, vector<cell> &path) {
+  uint32_t from, to;
+  if (!begin(start, goal, from, to, path)) {
+    return false;
+  }
+  if (open.capacity() < 4 * uint64_t(cells) + 1) {
+    open.reserve(4 * uint64_t(cells) + 1);
+  }
+  open.clear();
+  greater<uint64_t> after;
+  seen[from] = stamp;
+  parent[from] = kRoot;
+  distance[from] = 0;
+  uint32_t guess = uint32_t(abs(start.row - goal.row) +
+                            abs(start.col - goal.col));
+  open.push_back(uint64_t(guess) << 32 | from);
+  while (!open.empty()) {
+    pop_heap(open.begin(), open.end(), after);
+    uint64_t entry = open.back();
+    open.pop_back();
+    uint32_t index = uint32_t(entry);
+    uint32_t estimate = uint32_t(entry >> 32);
+    int row = int(index / cols), col = int(index % cols);
+    uint32_t remaining = uint32_t(abs(row - goal.row) + abs(col - goal.col));
+    if (estimate != distance[index] + remaining) {
+      continue; // a shorter route to index was found after this push
+    }
+    expanded++;
+    if (index == to) {
+      path.resize(distance[to] + 1);
+      trace(to, path.data() + path.size());
+      return true;
+    }
+    uint32_t reached[4];
+    unsigned char back[4];
+    int count = moves(index, reached, back);
+    for (int i = 0; i < count; i++) {
+      uint32_t next = reached[i];
+      uint32_t steps = distance[index] + 1;
+      if (seen[next] != stamp || steps < distance[next]) {
+        seen[next] = stamp;
+        parent[next] = back[i];
+        distance[next] = steps;
+        // a step brings the goal one closer or one further away
+        bool closer;
+        switch (back[i]) {
+        case kDown: // next is above
+          closer = goal.row < row;
+          break;
+        case kUp:
+          closer = goal.row > row;
+          break;
+        case kRight: // next is to the left
+          closer = goal.col < col;
+          break;
+        default:
+          closer = goal.col > col;
+          break;
+        }
+        uint32_t left = closer ? remaining - 1 : remaining + 1;
+        open.push_back(uint64_t(steps + left) << 32 | next);
+        push_heap(open.begin(), open.end(), after);
+      }
+    }
+  }
+  return false;
+}
+
+/*
+ * Grows the two searches a whole level at a time, always the one with
+ * the smaller frontier, out of a single queue: the forward search fills
+ * it from the front and the backward search from the back, which fits
+ * since every cell joins at most one of them.  The shortest meeting over
+ * the first level that meets at all is the shortest path.
+ */
+bool MazeSolver::solveBidirectional(cell start, cell goal,
+                                    vector<cell> &path) {
+  uint32_t from, to;
+  if (!begin(start, goal, from, to, path)) {
+    return false;
+  }
+  uint32_t forward = stamp, backward = stamp + 1;
+  seen[from] = forward;
+  parent[from] = kRoot;
+  distance[from] = 0;
+  if (from == to) {
+    expanded = 1;
+    path.resize(1);
+    trace(from, path.data() + 1);
+    return true;
+  }
+  seen[to] = backward;
+  parent[to] = kRoot;
+  distance[to] = 0;
+  queue[0] = from;
+  queue[cells - 1] = to;
+  uint32_t frontHead = 0, frontTail = 1;    // forward level is [head, tail)
+  uint32_t backHead = cells, backTail = cells - 1; // backward is [tail, head)
+
+  while (frontHead < frontTail && backTail < backHead) {
+    bool fromFront = frontTail - frontHead <= backHead - backTail;
+    uint32_t mine = fromFront ? forward : backward;
+    uint32_t theirs = fromFront ? backward : forward;
+    uint32_t best = UINT32_MAX, meetMine = 0, meetTheirs = 0;
+    uint32_t levelEnd = fromFront ? frontTail : backTail;
+    while (fromFront ? frontHead < levelEnd : backHead > levelEnd) {
+      uint32_t index = fromFront ? queue[frontHead++] : queue[--backHead];
+      expanded++;
+      uint32_t reached[4];
+      unsigned char back[4];
+      int count = moves(index, reached, back);
+      for (int i = 0; i < count; i++) {
+        uint32_t next = reached[i];
+        if (seen[next] == theirs) {
+          uint32_t length = distance[index] + 1 + distance[next];
+          if (length < best) {
+            best = length;
+            meetMine = index;
+            meetTheirs = next;
+          }
+        } else if (seen[next] != mine) {
+          seen[next] = mine;
+          parent[next] = back[i];
+          distance[next] = distance[index] + 1;
+          if (fromFront) {
+            queue[frontTail++] = next;
+          } else {
+            queue[--backTail] = next;
+          }
+        }
+      }
+    }
+    if (best != UINT32_MAX) {
+      uint32_t meetFront = fromFront ? meetMine : meetTheirs;
+      uint32_t meetBack = fromFront ? meetTheirs : meetMine;
+      path.resize(best + 1);
+      trace(meetFront, path.data() + distance[meetFront] + 1);
+      // the backward half comes out goal first, so reverse it in place
+      cell *half = path.data() + distance[meetFront] + 1;
+      trace(meetBack, half + distance[meetBack] + 1);
+      reverse(half, half + distance[meetBack] + 1);
+      return true;
+    }
+  }
+  return false;
+}
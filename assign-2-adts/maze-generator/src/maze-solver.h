@@ -0,0 +1,71 @@
+/**
+ * File: maze-solver.h
+ * -------------------
+ * Defines a solver that finds the shortest path between two cells of a
+ * maze recorded in a MazePassages, by breadth-first search, by A* with
+ * the Manhattan distance as its heuristic, or by breadth-first search
+ * from both ends at once.
+ *
+ * The solver owns all the scratch space a search needs, sized to the
+ * maze on first use, and marks cells with a stamp that changes with
+ * every search rather than clearing them, so a search allocates nothing
+ * and costs time in proportion to the cells it reaches, not to the size
+ * of the maze.  Paths are written into a vector the caller keeps, which
+ * only allocates while it grows.
+ */
+
+#ifndef _maze_solver_
+#define _maze_solver_
+
+#include <cstdint>
+#include <vector>
+
+#include "maze-passages.h"
+#include "maze-types.h"
+
+class MazeSolver {
+public:
+  /**
+   * Creates a solver for the given maze, which must outlive it.  The
+   * maze may change between searches, including its dimensions.
+   */
+  explicit MazeSolver(const MazePassages &maze);
+
+  /**
+   * Each of these stores the shortest path from start to goal in path,
+   * both ends included, and returns true, or returns false, leaving path
+   * empty, if no path joins them or either lies outside the maze.
+   */
+  bool solveBreadthFirst(cell start, cell goal, std::vector<cell> &path);
+  bool solveAStar(cell start, cell goal, std::vector<cell> &path);
+  bool solveBidirectional(cell start, cell goal, std::vector<cell> &path);
+
+  /**
+   * Returns the number of cells the last search expanded.
+   */
+  uint32_t getExpandedCount() const { return expanded; }
+
+private:
+  const MazePassages &maze;
+  uint32_t cols;
+  uint32_t cells;
+  std::vector<uint32_t> seen;        // stamp of the last search to reach a cell
+  std::vector<unsigned char> parent; // direction back towards the search's root
+  std::vector<uint32_t> distance;    // steps from the search's root
+  std::vector<uint32_t> queue;
+  std::vector<uint64_t> open; // A*'s heap of (estimate << 32 | cell)
+  uint32_t stamp;
+  uint32_t expanded;
+
+  MazeSolver(const MazeSolver &original);
+  void operator=(const MazeSolver &rhs) const;
+
+  bool begin(cell start, cell goal, uint32_t &from, uint32_t &to,
+             std::vector<cell> &path);
+  int moves(uint32_t index, uint32_t reached[4],
+            unsigned char back[4]) const;
+  uint32_t step(uint32_t index, unsigned char direction) const;
+  void trace(uint32_t index, cell *end) const;
+};
+
+#endif
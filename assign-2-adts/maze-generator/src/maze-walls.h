@@ -0,0 +1,152 @@
+/**
+ * File: maze-walls.h
+ * ------------------
+ * Numbers the interior walls of a square maze so that generators can
+ * store them as plain integers rather than pairs of cells, and defines
+ * the stream of walls through which generators hand removed walls to
+ * the view.
+ *
+ * In a maze of dimension d, cell (row, col) has index row * d + col, and
+ * the 2 * d * (d - 1) interior walls are numbered as follows:
+ *
+ *  - IDs [0, d * (d - 1)) separate (row, col) from (row, col + 1), with
+ *    ID row * (d - 1) + col;
+ *  - IDs [d * (d - 1), 2 * d * (d - 1)) separate (row, col) from
+ *    (row + 1, col), with ID d * (d - 1) + row * d + col.
+ *
+ * Nothing here depends on the Stanford library, so generators can also
+ * run without any graphics.
+ */
+
+#ifndef _maze_walls_
+#define _maze_walls_
+
+#include <cstdint>
+
+#include "maze-types.h"
+
+/**
+ * Constant: kMaxMazeDimension
+ * ---------------------------
+ * The largest dimension whose wall IDs fit in 32 bits.
+ */
+static const int kMaxMazeDimension = 46341;
+
+/**
+ * Function: mazeWallCount
+ * -----------------------
+ * Returns the number of interior walls in a maze of the given dimension.
+ */
+inline uint32_t mazeWallCount(int dimension) {
+  return 2 * uint32_t(dimension) * uint32_t(dimension - 1);
+}
+
+/**
+ * Function: mazeWallCells
+ * -----------------------
+ * Stores the indexes of the two cells the wall separates, the upper or
+ * left one first.
+ */
+inline void mazeWallCells(int dimension, uint32_t wallId, uint32_t &first,
+                          uint32_t &second) {
+  uint32_t d = uint32_t(dimension);
+  uint32_t across = d * (d - 1);
+  if (wallId < across) {
+    uint32_t row = wallId / (d - 1);
+    first = row * d + wallId % (d - 1);
+    second = first + 1;
+  } else {
+    first = wallId - across;
+    second = first + d;
+  }
+}
+
+/**
+ * Function: mazeWall
+ * ------------------
+ * Returns the wall with the given ID as the pair of cells it separates.
+ */
+inline wall mazeWall(int dimension, uint32_t wallId) {
+  uint32_t first, second;
+  mazeWallCells(dimension, wallId, first, second);
+  wall w = {{int(first / dimension), int(first % dimension)},
+            {int(second / dimension), int(second % dimension)}};
+  return w;
+}
+
+/**
+ * Function: mazeWallBetween
+ * -------------------------
+ * Returns the wall between two adjacent cells given by index, in either
+ * order.
+ */
+inline wall mazeWallBetween(int dimension, uint32_t one, uint32_t two) {
+  if (two < one) {
+    uint32_t earlier = two;
+    two = one;
+    one = earlier;
+  }
+  wall w = {{int(one / dimension), int(one % dimension)},
+            {int(two / dimension), int(two % dimension)}};
+  return w;
+}
+
+/**
+ * Function: mazeNeighbours
+ * ------------------------
+ * Stores the indexes of the cells adjacent to the given one in
+ * neighbours and returns how many there are, between 0 and 4.
+ */
+inline int mazeNeighbours(int dimension, uint32_t cell,
+                          uint32_t neighbours[4]) {
+  uint32_t d = uint32_t(dimension);
+  uint32_t col = cell % d;
+  int count = 0;
+  if (cell >= d) {
+    neighbours[count++] = cell - d;
+  }
+  if (col > 0) {
+    neighbours[count++] = cell - 1;
+  }
+  if (col + 1 < d) {
+    neighbours[count++] = cell + 1;
+  }
+  if (cell + d < d * d) {
+    neighbours[count++] = cell + d;
+  }
+  return count;
+}
+
+/**
+ * Function: mazeWallId
+ * --------------------
+ * Returns the ID of a wall between two adjacent cells, given in order.
+ */
+inline uint32_t mazeWallId(int dimension, const wall &w) {
+  uint32_t d = uint32_t(dimension);
+  if (w.one.row == w.two.row) {
+    return uint32_t(w.one.row) * (d - 1) + uint32_t(w.one.col);
+  }
+  return d * (d - 1) + uint32_t(w.one.row) * d + uint32_t(w.one.col);
+}
+
+/**
+ * Class: MazeWallStream
+ * ---------------------
+ * A source of walls, produced one at a time so that neither the
+ * generator nor its consumer ever needs the whole list of removed walls.
+ * Rectangular mazes use the same wall type, with rows and columns
+ * counted from the upper-left cell.
+ */
+class MazeWallStream {
+public:
+  virtual ~MazeWallStream() {}
+
+  /**
+   * Stores the next wall and returns true, or returns false once the
+   * stream is exhausted.
+   */
+  virtual bool next(wall &w) = 0;
+};
+
+#endif
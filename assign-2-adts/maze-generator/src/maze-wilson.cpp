@@ -0,0 +1,78 @@
+/**
+ * File: maze-wilson.cpp
+ * ---------------------
+ * Implements the Wilson maze generator.
+ */
+
+#include "maze-wilson.h"
+
+using namespace std;
+
+// marks cursor as having no path left to add
+static const uint32_t kNoPath = UINT32_MAX;
+
+// headings, in the order of mazeNeighbours
+enum { kUp, kLeft, kRight, kDown };
+
+WilsonMazeGenerator::WilsonMazeGenerator(int dimension, uint64_t seed)
+    : MazeGenerator(dimension, dimension), dimension(dimension),
+      inTree(uint32_t(dimension) * uint32_t(dimension), 0),
+      heading(inTree.size(), 0), start(0), cursor(kNoPath), random(seed) {
+  inTree[random.below(uint32_t(inTree.size()))] = 1;
+}
+
+/*
+ * Walks at random from start until the walk meets the tree, leaving each
+ * cell's heading as the direction it was last left by.  Following those
+ * headings from start retraces the walk without any of its loops.
+ */
+void WilsonMazeGenerator::walk() {
+  uint32_t d = uint32_t(dimension);
+  uint32_t cell = start;
+  while (!inTree[cell]) {
+    uint32_t row = cell / d, col = cell % d;
+    unsigned char direction;
+    while (true) {
+      direction = (unsigned char)(random.coin() * 2 + random.coin());
+      if ((direction == kUp && row > 0) || (direction == kLeft && col > 0) ||
+          (direction == kRight && col + 1 < d) ||
+          (direction == kDown && row + 1 < d)) {
+        break;
+      }
+    }
+    heading[cell] = direction;
+    cell = step(cell);
+  }
+}
+
+uint32_t WilsonMazeGenerator::step(uint32_t cell) const {
+  switch (heading[cell]) {
+  case kUp:
+    return cell - uint32_t(dimension);
+  case kLeft:
+    return cell - 1;
+  case kRight:
+    return cell + 1;
+  default:
+    return cell + uint32_t(dimension);
+  }
+}
+
+bool WilsonMazeGenerator::next(wall &w) {
+  if (cursor == kNoPath) {
+    while (start < inTree.size() && inTree[start]) {
+      start++;
+    }
+    if (start == inTree.size()) {
+      return false;
+    }
+    walk();
+    cursor = start;
+  }
+  // add the path one cell, and so one wall, at a time
+  uint32_t following = step(cursor);
+  inTree[cursor] = 1;
+  w = mazeWallBetween(dimension, cursor, following);
+  cursor = inTree[following] ? kNoPath : following;
+  return true;
+}
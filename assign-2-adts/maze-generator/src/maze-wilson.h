@@ -0,0 +1,53 @@
+/**
+ * File: maze-wilson.h
+ * -------------------
+ * Defines a maze generator based on Wilson's algorithm, which draws
+ * uniformly from every spanning tree of the cells, so unlike the other
+ * generators it favours no particular texture.  One random cell starts
+ * the tree; then, from each cell outside it, a random walk runs until it
+ * reaches the tree, and the walk with its loops erased is added.
+ *
+ * Loops are erased for free by remembering only the direction in which
+ * each cell was last left, so a maze of n cells costs 2 bytes per cell.
+ * The early walks are long, since the tree is a small target, so the
+ * first walls come out much more slowly than the rest.
+ */
+
+#ifndef _maze_wilson_
+#define _maze_wilson_
+
+#include <cstdint>
+#include <vector>
+
+#include "maze-generators.h"
+
+class WilsonMazeGenerator : public MazeGenerator {
+public:
+  /**
+   * Prepares a maze of the given dimension, between 1 and
+   * kMaxMazeDimension, with every interior wall standing.  The same seed
+   * always produces the same maze.
+   */
+  WilsonMazeGenerator(int dimension, uint64_t seed);
+
+  /**
+   * Stores the next wall to remove and returns true, or returns false
+   * once the maze is complete, after dimension^2 - 1 removals.
+   */
+  bool next(wall &w) override;
+
+  std::string getName() const override { return "wilson"; }
+
+private:
+  int dimension;
+  std::vector<unsigned char> inTree;
+  std::vector<unsigned char> heading; // direction each walk last left by
+  uint32_t start;                     // cells before start are all in the tree
+  uint32_t cursor;                    // where the current path is added from
+  MazeRandom random;
+
+  void walk();
+  uint32_t step(uint32_t cell) const;
+};
+
+#endif
@@ -0,0 +1,447 @@
+/**
+ * File: lexicon-bench.cpp
+ * -----------------------
+ * Compares the Stanford Lexicon with CompactLexicon.
+ *
+ *   lexicon-bench [--dictionary path] [--lexicon path] [--lookups N]
+ *                 [--seed S] [--format csv|json]
+ *
+ * Loads the dictionary, ../dictionary.txt by default, into each lexicon
+ * in a child process of its own: the Stanford Lexicon and CompactLexicon
+ * read the word list, and the "mapped" CompactLexicon loads the binary
+ * lexicon saved from it beforehand, lexicon-bench.lexicon by default,
+ * as the word ladder does at startup.  Prints one record per lexicon with
+ * the load time, the growth in peak resident set size the load caused,
+ * the time to iterate over every word, and contains and containsPrefix
+ * lookups/second.  The N lookups are the same for both: half are words
+ * drawn from the dictionary and half are those words with one letter
+ * changed, most of which are not words, and prefix lookups use the first
+ * half of each.  Variant lookups test every one-letter change of the
+ * queries, as a word ladder does, until N words have been tested: the
+ * Stanford Lexicon looks each one up whole, and CompactLexicon walks
+ * each position's prefix once with a cursor and tries every letter from
+ * there.  The records also count the hits, which must agree.
+ */
+
+#include <sys/resource.h> // for getrusage
+#include <sys/wait.h>     // for waitpid
+#include <unistd.h>       // for fork, pipe
+
+#include <algorithm>
+#include <cctype>  // for isdigit
+#include <cerrno>  // for errno, ERANGE
+#include <chrono>
+#include <climits> // for INT_MAX, INT_MIN
+#include <cstdlib> // for strtol, strtoull
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "compact-lexicon.h"
+#include "lexicon.h"
+
+struct BenchOptions {
+  string dictionary = "../dictionary.txt";
+  string lexicon = "lexicon-bench.lexicon";
+  int lookups = 1000000;
+  uint64_t seed = 106;
+  string format = "csv";
+};
+
+static void usage() {
+  cerr << "usage: lexicon-bench [--dictionary path] [--lexicon path]"
+       << " [--lookups N]" << endl
+       << "                     [--seed S] [--format csv|json]" << endl;
+}
+
+/*
+ * Each of these stores the whole of value, read as a decimal number, in
+ * result and returns true, or returns false if value holds anything else
+ * or a number out of result's range.
+ */
+static bool parseInt(const string &value, int &result) {
+  char *end;
+  errno = 0;
+  long number = strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || errno == ERANGE || number < INT_MIN ||
+      number > INT_MAX) {
+    return false;
+  }
+  result = int(number);
+  return true;
+}
+
+static bool parseUnsigned(const string &value, uint64_t &result) {
+  char *end;
+  errno = 0;
+  unsigned long long number = strtoull(value.c_str(), &end, 10);
+  if (value.empty() || !isdigit((unsigned char)value[0]) || *end != '\0' ||
+      errno == ERANGE) {
+    return false;
+  }
+  result = number;
+  return true;
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    string flag = argv[i];
+    if (i + 1 >= argc) {
+      cerr << flag << " needs a value" << endl;
+      return false;
+    }
+    string value = argv[++i];
+    bool number = true;
+    if (flag == "--dictionary") {
+      options.dictionary = value;
+    } else if (flag == "--lexicon") {
+      options.lexicon = value;
+    } else if (flag == "--lookups") {
+      number = parseInt(value, options.lookups);
+    } else if (flag == "--seed") {
+      number = parseUnsigned(value, options.seed);
+    } else if (flag == "--format") {
+      options.format = value;
+    } else {
+      cerr << "unknown option " << flag << endl;
+      return false;
+    }
+    if (!number) {
+      cerr << flag << " needs a number, not " << value << endl;
+      return false;
+    }
+  }
+  return options.lookups > 0 &&
+         (options.format == "csv" || options.format == "json");
+}
+
+// peak resident set size of this process so far, in kilobytes
+static long peakResidentKilobytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024; // reported in bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+static string jsonString(const string &text) {
+  string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"' || ch == '\\') {
+      quoted += '\\';
+    }
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+struct LexiconRecord {
+  int words;
+  double loadSeconds;
+  long loadKilobytes;
+  double iterateSeconds;
+  double containsSeconds;
+  double prefixSeconds;
+  double variantSeconds;
+  int containsHits;
+  int prefixHits;
+  int variants;
+  int variantHits;
+};
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/*
+ * Counts the one-letter changes of word that are words, looking each one
+ * up from scratch.
+ */
+template <typename L>
+static int countVariants(const L &lexicon, const string &word) {
+  string variant = word;
+  int hits = 0;
+  for (size_t position = 0; position < word.size(); position++) {
+    for (char letter = 'a'; letter <= 'z'; letter++) {
+      if (letter != word[position]) {
+        variant[position] = letter;
+        hits += lexicon.contains(variant);
+      }
+    }
+    variant[position] = word[position];
+  }
+  return hits;
+}
+
+/*
+ * Counts the same words with cursors, which share the walk to each
+ * position and abandon a variant as soon as no word starts with it.
+ */
+static int countVariants(const CompactLexicon &lexicon, const string &word) {
+  int hits = 0;
+  CompactLexicon::Cursor stem = lexicon.getCursor();
+  for (size_t position = 0; position < word.size(); position++) {
+    for (char letter = 'a'; letter <= 'z'; letter++) {
+      CompactLexicon::Cursor variant = stem;
+      if (letter == word[position] || !variant.advance(letter)) {
+        continue;
+      }
+      size_t next = position + 1;
+      while (next < word.size() && variant.advance(word[next])) {
+        next++;
+      }
+      hits += next == word.size() && variant.isWord();
+    }
+    if (!stem.advance(word[position])) {
+      break; // only happens if word itself is not a prefix of any word
+    }
+  }
+  return hits;
+}
+
+/*
+ * Times everything but the load on a lexicon already loaded, for any
+ * type with the Lexicon's iteration and lookups.
+ */
+template <typename L>
+static void measureLookups(const L &lexicon, const vector<string> &queries,
+                           LexiconRecord &record) {
+  auto start = chrono::steady_clock::now();
+  int words = 0;
+  for (const string &word : lexicon) {
+    words += !word.empty();
+  }
+  record.iterateSeconds = secondsSince(start);
+  record.words = words;
+
+  start = chrono::steady_clock::now();
+  int hits = 0;
+  for (const string &query : queries) {
+    hits += lexicon.contains(query);
+  }
+  record.containsSeconds = secondsSince(start);
+  record.containsHits = hits;
+
+  vector<string> prefixes;
+  for (const string &query : queries) {
+    prefixes.push_back(query.substr(0, (query.size() + 1) / 2));
+  }
+  start = chrono::steady_clock::now();
+  hits = 0;
+  for (const string &prefix : prefixes) {
+    hits += lexicon.containsPrefix(prefix);
+  }
+  record.prefixSeconds = secondsSince(start);
+  record.prefixHits = hits;
+
+  start = chrono::steady_clock::now();
+  int variants = 0;
+  hits = 0;
+  for (size_t i = 0; variants < int(queries.size()); i++) {
+    const string &word = queries[i % queries.size()];
+    hits += countVariants(lexicon, word);
+    variants += 25 * int(word.size());
+  }
+  record.variantSeconds = secondsSince(start);
+  record.variants = variants;
+  record.variantHits = hits;
+}
+
+// loads the named lexicon and fills in the record, or returns false
+static bool measureLexicon(const string &name, const BenchOptions &options,
+                           const vector<string> &queries,
+                           LexiconRecord &record) {
+  long before = peakResidentKilobytes();
+  auto start = chrono::steady_clock::now();
+  if (name == "stanford") {
+    Lexicon lexicon(options.dictionary);
+    record.loadSeconds = secondsSince(start);
+    record.loadKilobytes = peakResidentKilobytes() - before;
+    measureLookups(lexicon, queries, record);
+    return true;
+  }
+  CompactLexicon lexicon;
+  string error;
+  bool loaded = name == "mapped"
+                    ? lexicon.load(options.lexicon, error)
+                    : lexicon.addWordsFromFile(options.dictionary, error);
+  if (!loaded) {
+    cerr << error << endl;
+    return false;
+  }
+  record.loadSeconds = secondsSince(start);
+  record.loadKilobytes = peakResidentKilobytes() - before;
+  measureLookups(lexicon, queries, record);
+  return true;
+}
+
+/*
+ * Measures one lexicon in a child process and returns its record through
+ * a pipe, or returns false if the child could not be run.
+ */
+static bool measure(const string &name, const BenchOptions &options,
+                    const vector<string> &queries, LexiconRecord &record) {
+  int channel[2];
+  if (pipe(channel) != 0) {
+    return false;
+  }
+  pid_t child = fork();
+  if (child < 0) {
+    close(channel[0]);
+    close(channel[1]);
+    return false;
+  }
+  if (child == 0) {
+    close(channel[0]);
+    LexiconRecord measured;
+    bool sent = measureLexicon(name, options, queries, measured) &&
+                write(channel[1], &measured, sizeof(measured)) ==
+                    ssize_t(sizeof(measured));
+    _exit(sent ? 0 : 1);
+  }
+  close(channel[1]);
+  bool received =
+      read(channel[0], &record, sizeof(record)) == ssize_t(sizeof(record));
+  close(channel[0]);
+  int status;
+  waitpid(child, &status, 0);
+  return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// draws the queries from the dictionary before any lexicon is loaded
+static bool makeQueries(const BenchOptions &options, vector<string> &queries) {
+  ifstream input(options.dictionary.c_str());
+  vector<string> words;
+  string line;
+  while (getline(input, line)) {
+    line.erase(0, line.find_first_not_of(" \t\r"));
+    line.erase(line.find_last_not_of(" \t\r") + 1);
+    if (!line.empty()) {
+      words.push_back(line);
+    }
+  }
+  if (words.empty()) {
+    cerr << "no words in " << options.dictionary << endl;
+    return false;
+  }
+  mt19937 random(options.seed);
+  uniform_int_distribution<size_t> pick(0, words.size() - 1);
+  uniform_int_distribution<int> letter('a', 'z');
+  queries.resize(options.lookups);
+  for (int i = 0; i < options.lookups; i++) {
+    queries[i] = words[pick(random)];
+    if (i % 2 == 1) {
+      uniform_int_distribution<size_t> position(0, queries[i].size() - 1);
+      queries[i][position(random)] = char(letter(random));
+    }
+  }
+  return true;
+}
+
+/*
+ * Saves the binary lexicon in a child process, so that the memory it
+ * takes to build isn't left for the measured children to reuse.
+ */
+static bool saveLexicon(const BenchOptions &options) {
+  pid_t child = fork();
+  if (child < 0) {
+    return false;
+  }
+  if (child == 0) {
+    CompactLexicon lexicon;
+    string error;
+    if (!lexicon.addWordsFromFile(options.dictionary, error) ||
+        !lexicon.save(options.lexicon, error)) {
+      cerr << error << endl;
+      _exit(1);
+    }
+    _exit(0);
+  }
+  int status;
+  waitpid(child, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    usage();
+    return 1;
+  }
+  vector<string> queries;
+  if (!makeQueries(options, queries)) {
+    return 1;
+  }
+  if (!saveLexicon(options)) {
+    return 1;
+  }
+
+  if (options.format == "csv") {
+    cout << "lexicon,words,load_seconds,load_rss_kb,iterate_seconds,"
+         << "contains_per_sec,prefix_per_sec,variants_per_sec,contains_hits,"
+         << "prefix_hits,variant_hits" << endl;
+  } else {
+    cout << "[" << endl;
+  }
+  const string names[] = {"stanford", "compact", "mapped"};
+  const int kLexicons = 3;
+  LexiconRecord records[kLexicons];
+  int failures = 0;
+  for (int which = 0; which < kLexicons; which++) {
+    const string &name = names[which];
+    LexiconRecord &record = records[which];
+    if (!measure(name, options, queries, record)) {
+      cerr << name << " could not be measured" << endl;
+      return 1;
+    }
+    double containsPerSecond =
+        options.lookups / max(record.containsSeconds, 1e-9);
+    double prefixPerSecond = options.lookups / max(record.prefixSeconds, 1e-9);
+    double variantsPerSecond =
+        record.variants / max(record.variantSeconds, 1e-9);
+    if (options.format == "csv") {
+      cout << name << "," << record.words << "," << fixed << setprecision(6)
+           << record.loadSeconds << "," << record.loadKilobytes << ","
+           << record.iterateSeconds << "," << scientific << setprecision(4)
+           << containsPerSecond << "," << prefixPerSecond << ","
+           << variantsPerSecond << "," << record.containsHits << ","
+           << record.prefixHits << "," << record.variantHits << endl;
+    } else {
+      cout << (which == 0 ? "  " : ",\n  ")
+           << "{\"lexicon\": " << jsonString(name)
+           << ", \"words\": " << record.words << ", \"load_seconds\": "
+           << fixed << setprecision(6) << record.loadSeconds
+           << ", \"load_rss_kb\": " << record.loadKilobytes
+           << ", \"iterate_seconds\": " << record.iterateSeconds
+           << ", \"contains_per_sec\": " << scientific << setprecision(4)
+           << containsPerSecond << ", \"prefix_per_sec\": " << prefixPerSecond
+           << ", \"variants_per_sec\": " << variantsPerSecond
+           << ", \"contains_hits\": " << record.containsHits
+           << ", \"prefix_hits\": " << record.prefixHits
+           << ", \"variant_hits\": " << record.variantHits << "}";
+    }
+  }
+  if (options.format == "json") {
+    cout << "\n]" << endl;
+  }
+  for (int which = 1; which < kLexicons; which++) {
+    const LexiconRecord &record = records[which];
+    if (record.words != records[0].words ||
+        record.containsHits != records[0].containsHits ||
+        record.prefixHits != records[0].prefixHits ||
+        record.variantHits != records[0].variantHits) {
+      cerr << names[which] << " disagrees with " << names[0] << endl;
+      failures++;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#####################################################################
+## Benchmark of the Stanford Lexicon against CompactLexicon        ##
+#####################################################################
+#
+# Builds a console program that loads dictionary.txt into both lexicons
+# and compares load time, memory and lookup rates:
+#
+#     cd bench && qmake lexicon-bench.pro && make
+#     ./lexicon-bench --lookups 1000000
+#
+# The Stanford Lexicon lives in the Stanford library, which needs Qt
+# just as word-ladder.pro does, so the library is built here too.  The
+# program has its own plain main and never opens the graphical console.
+
+TEMPLATE = app
+TARGET = lexicon-bench
+CONFIG += console c++14
+CONFIG -= app_bundle
+QT       += core gui multimedia network
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+LIB = $$PWD/../lib/StanfordCPPLib
+
+INCLUDEPATH *= $$LIB/
+INCLUDEPATH *= $$LIB/collections/
+INCLUDEPATH *= $$LIB/graphics/
+INCLUDEPATH *= $$LIB/io/
+INCLUDEPATH *= $$LIB/system/
+INCLUDEPATH *= $$LIB/util/
+INCLUDEPATH *= $$PWD/../src/
+
+SOURCES *= $$PWD/lexicon-bench.cpp
+SOURCES *= $$PWD/../src/compact-lexicon.cpp
+SOURCES *= $$LIB/spl.cpp
+
+DEFINES += SPL_PROJECT_VERSION=20181023
+DEFINES += SPL_MERGED_LIBRARY_SINGLE_FILE
+DEFINES += SPL_PRECOMPILE_QT_MOC_FILES
+
+LIBS += -lpthread
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Wno-sign-compare
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
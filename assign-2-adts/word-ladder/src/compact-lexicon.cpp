@@ -0,0 +1,1048 @@
+/**
+ * File: compact-lexicon.cpp
+ * -------------------------
+ * Implements the compact lexicon.
+ *
+ * Saved lexicons are little-endian whatever the machine, laid out as
+ *
+ *   "CLEX", version, node count n, edge count e, root, word count,
+ *   nodes (n + 1 words), targets (e words), labels (e bytes)
+ *
+ * where every number is 4 bytes, so each array starts 4-byte aligned and
+ * a little-endian machine can use a mapped file as it stands.
+ */
+
+#include "compact-lexicon.h"
+
+#include <algorithm> // for binary_search, count, is_sorted, lower_bound, max,
+                     // min, sort, unique, upper_bound
+#include <atomic>
+#include <cctype>    // for tolower
+#include <cstdio>    // for remove, rename
+#include <cstring>   // for memchr, memcmp, memcpy, strlen
+#include <fstream>
+#include <iterator>  // for istreambuf_iterator
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>    // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close, getpid
+#endif
+using namespace std;
+
+// bump whenever the layout of saved lexicons changes
+static const uint32_t kFormatVersion = 1;
+static const char kMagic[4] = {'C', 'L', 'E', 'X'};
+static const size_t kHeaderBytes = 24;
+
+// the overlay is folded into the DAWG once it holds more than this many
+// words, or an eighth of the DAWG's words if that is more
+static const size_t kMinOverlayLimit = 1024;
+
+// tolower, without the call for the ASCII letters nearly every word uses
+static unsigned char foldLetter(char ch) {
+  unsigned char letter = (unsigned char)ch;
+  if (letter < 0x80) {
+    return letter >= 'A' && letter <= 'Z' ? letter + ('a' - 'A') : letter;
+  }
+  return (unsigned char)tolower(letter);
+}
+
+static string toLowerCase(string word) {
+  for (char &ch : word) {
+    ch = char(foldLetter(ch));
+  }
+  return word;
+}
+
+// the characters trimmed from either end of a line of a word list
+static bool isLineSpace(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+/*
+ * Compares a lower-case word with letters yet to be folded to lower
+ * case, in the same order as std::string's operator<, returning a
+ * negative, zero or positive number.  If prefixOnly is set, word counts
+ * as equal when the letters are a prefix of it.
+ */
+static int compareFolded(const string &word, const char *letters,
+                         size_t length, bool prefixOnly = false) {
+  size_t common = min(word.size(), length);
+  for (size_t i = 0; i < common; i++) {
+    unsigned char one = (unsigned char)word[i], two = foldLetter(letters[i]);
+    if (one != two) {
+      return one < two ? -1 : 1;
+    }
+  }
+  if (word.size() == length || (prefixOnly && word.size() > length)) {
+    return 0;
+  }
+  return word.size() < length ? -1 : 1;
+}
+
+bool CompactLexicon::OverlayOrder::operator()(const string &word,
+                                              const FoldedKey &key) const {
+  return compareFolded(word, key.letters, key.length) < 0;
+}
+
+bool CompactLexicon::Overlay::contains(const string &word) const {
+  return binary_search(words.begin(), words.end(), word);
+}
+
+bool CompactLexicon::Overlay::contains(const FoldedKey &key) const {
+  const_iterator found = lowerBound(key);
+  return found != words.end() &&
+         compareFolded(*found, key.letters, key.length) == 0;
+}
+
+CompactLexicon::Overlay::const_iterator
+CompactLexicon::Overlay::lowerBound(const FoldedKey &key) const {
+  return lower_bound(words.begin(), words.end(), key, OverlayOrder());
+}
+
+CompactLexicon::Overlay::const_iterator
+CompactLexicon::Overlay::upperBound(const string &word) const {
+  return upper_bound(words.begin(), words.end(), word);
+}
+
+bool CompactLexicon::Overlay::insert(const string &word) {
+  auto at = lower_bound(words.begin(), words.end(), word);
+  if (at != words.end() && *at == word) {
+    return false;
+  }
+  words.insert(at, word);
+  return true;
+}
+
+bool CompactLexicon::Overlay::erase(const string &word) {
+  auto at = lower_bound(words.begin(), words.end(), word);
+  if (at == words.end() || *at != word) {
+    return false;
+  }
+  words.erase(at);
+  return true;
+}
+
+// a word to build from, already folded to lower case, as its letters
+// and length in storage that outlives the build
+typedef pair<const char *, size_t> WordSpan;
+
+static bool spanLess(const WordSpan &one, const WordSpan &two) {
+  int order = memcmp(one.first, two.first, min(one.second, two.second));
+  return order < 0 || (order == 0 && one.second < two.second);
+}
+
+static bool spanEqual(const WordSpan &one, const WordSpan &two) {
+  return one.second == two.second &&
+         memcmp(one.first, two.first, one.second) == 0;
+}
+
+// the flag on a node that ends a word, as CompactLexicon::kTerminal
+static const uint32_t kTerminalBit = 0x80000000;
+
+namespace {
+
+typedef pair<unsigned char, uint32_t> Edge; // (letter, target)
+
+/*
+ * The finished nodes of a DAWG in the lexicon's layout, each made only
+ * after all its children, with a register of them: a hash table that
+ * finds an existing node equal to a new one, that is one with the same
+ * edges and ending a word or not alike.  Equal nodes have equal
+ * subtrees, so making every node through the register keeps the DAWG
+ * minimal.
+ */
+struct FrozenNodes {
+  vector<uint32_t> nodes; // no final entry until the build is finished
+  vector<unsigned char> labels;
+  vector<uint32_t> targets;
+  vector<uint32_t> table; // node + 1 in each used slot, 0 in free ones
+  size_t used;
+
+  FrozenNodes() : table(1024, 0), used(0) {}
+
+  static uint64_t mix(uint64_t hash, unsigned char letter, uint32_t target) {
+    hash = (hash ^ (uint64_t(letter) << 32 | target)) * 0xff51afd7ed558ccdULL;
+    return hash ^ (hash >> 29);
+  }
+
+  size_t edgesEnd(uint32_t node) const {
+    return node + 1 < nodes.size() ? nodes[node + 1] & ~kTerminalBit
+                                   : labels.size();
+  }
+
+  size_t hashOf(uint32_t node) const {
+    uint64_t hash = (nodes[node] & kTerminalBit) ? 0x9e3779b97f4a7c15ULL : 0;
+    size_t end = edgesEnd(node);
+    for (size_t edge = nodes[node] & ~kTerminalBit; edge < end; edge++) {
+      hash = mix(hash, labels[edge], targets[edge]);
+    }
+    return size_t(hash ^ (hash >> 32));
+  }
+
+  bool matches(uint32_t node, bool terminal, const vector<Edge> &edges) const {
+    size_t first = nodes[node] & ~kTerminalBit;
+    if (((nodes[node] & kTerminalBit) != 0) != terminal ||
+        edgesEnd(node) - first != edges.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < edges.size(); i++) {
+      if (labels[first + i] != edges[i].first ||
+          targets[first + i] != edges[i].second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void insert(uint32_t node, size_t hash) {
+    size_t mask = table.size() - 1;
+    size_t slot = hash & mask;
+    while (table[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    table[slot] = node + 1;
+    used++;
+  }
+
+  // returns the node equal to the one described, making it if need be
+  uint32_t freeze(bool terminal, const vector<Edge> &edges) {
+    uint64_t mixed = terminal ? 0x9e3779b97f4a7c15ULL : 0;
+    for (const Edge &edge : edges) {
+      mixed = mix(mixed, edge.first, edge.second);
+    }
+    size_t hash = size_t(mixed ^ (mixed >> 32));
+    size_t mask = table.size() - 1;
+    for (size_t slot = hash & mask; table[slot] != 0;
+         slot = (slot + 1) & mask) {
+      if (matches(table[slot] - 1, terminal, edges)) {
+        return table[slot] - 1;
+      }
+    }
+
+    uint32_t node = uint32_t(nodes.size());
+    nodes.push_back(uint32_t(labels.size()) | (terminal ? kTerminalBit : 0));
+    for (const Edge &edge : edges) {
+      labels.push_back(edge.first);
+      targets.push_back(edge.second);
+    }
+    if (2 * (used + 1) <= table.size()) {
+      insert(node, hash);
+    } else {
+      // doubles the table, keeping it at most half full
+      table.assign(table.size() * 2, 0);
+      used = 0;
+      for (uint32_t made = 0; made < nodes.size(); made++) {
+        insert(made, hashOf(made));
+      }
+    }
+    return node;
+  }
+};
+
+/*
+ * Builds a minimal DAWG from sorted, distinct words in one pass, after
+ * Daciuk et al.: the nodes along the last word added stay open, since a
+ * later word may still add edges to them, and the moment a word leaves
+ * the last one's path, every open node past the shared prefix can never
+ * change again and is frozen, deepest first.  At most one word's worth
+ * of nodes is ever open, and their edge lists are reused from word to
+ * word and from one build to the next.
+ */
+struct DawgBuilder {
+  struct OpenNode {
+    bool terminal;
+    vector<Edge> edges; // only the last edge's target is not yet frozen
+  };
+
+  vector<OpenNode> path; // path[d] is reached by d letters of the last word
+  size_t depth;
+
+  void open(size_t at) {
+    if (path.size() <= at) {
+      path.resize(at + 1);
+    }
+    path[at].terminal = false;
+    path[at].edges.clear();
+  }
+
+  void freezeDownTo(FrozenNodes &frozen, size_t common) {
+    for (; depth > common; depth--) {
+      OpenNode &node = path[depth];
+      path[depth - 1].edges.back().second =
+          frozen.freeze(node.terminal, node.edges);
+    }
+  }
+
+  // returns the root of the DAWG of the words with their first skip
+  // letters, which they all share, left out
+  uint32_t build(FrozenNodes &frozen, const WordSpan *words, size_t count,
+                 size_t skip) {
+    open(0);
+    depth = 0;
+    const char *last = nullptr;
+    for (size_t i = 0; i < count; i++) {
+      const char *letters = words[i].first + skip;
+      size_t length = words[i].second - skip;
+      size_t common = 0;
+      if (last != nullptr) {
+        while (common < depth && common < length &&
+               last[common] == letters[common]) {
+          common++;
+        }
+      }
+      freezeDownTo(frozen, common);
+      for (; depth < length; depth++) {
+        path[depth].edges.push_back(Edge((unsigned char)letters[depth], 0));
+        open(depth + 1);
+      }
+      path[depth].terminal = true;
+      last = letters;
+    }
+    freezeDownTo(frozen, 0);
+    return frozen.freeze(path[0].terminal, path[0].edges);
+  }
+};
+
+} // namespace
+
+/*
+ * Builds the DAWG of sorted, distinct words.  With more than one thread,
+ * the words are split by first letter into shards, each built into nodes
+ * of its own, and the shards are then merged children first through one
+ * register, which finds any nodes two shards share, so the result is as
+ * minimal as one built in a single pass.
+ */
+static uint32_t buildDawg(const vector<WordSpan> &words, int threads,
+                          FrozenNodes &frozen) {
+  if (threads <= 0) {
+    threads = max(1, int(thread::hardware_concurrency()));
+  }
+  if (threads == 1) {
+    DawgBuilder builder;
+    return builder.build(frozen, words.data(), words.size(), 0);
+  }
+
+  bool emptyWord = !words.empty() && words[0].second == 0;
+  vector<pair<size_t, size_t>> shards; // [low, high) of one first letter
+  for (size_t low = emptyWord ? 1 : 0; low < words.size();) {
+    size_t high = low + 1;
+    while (high < words.size() && words[high].first[0] == words[low].first[0]) {
+      high++;
+    }
+    shards.push_back(make_pair(low, high));
+    low = high;
+  }
+  vector<FrozenNodes> built(shards.size());
+  vector<uint32_t> roots(shards.size());
+  atomic<size_t> nextShard(0);
+  auto work = [&] {
+    DawgBuilder builder;
+    while (true) {
+      size_t shard = nextShard++;
+      if (shard >= shards.size()) {
+        return;
+      }
+      size_t low = shards[shard].first, high = shards[shard].second;
+      roots[shard] =
+          builder.build(built[shard], words.data() + low, high - low, 1);
+    }
+  };
+  threads = min(threads, max(1, int(shards.size())));
+  vector<thread> workers;
+  for (int i = 1; i < threads; i++) {
+    workers.push_back(thread(work));
+  }
+  work();
+  for (thread &worker : workers) {
+    worker.join();
+  }
+
+  vector<Edge> rootEdges, edges;
+  vector<uint32_t> merged; // a shard's node numbers in the whole DAWG
+  for (size_t shard = 0; shard < shards.size(); shard++) {
+    const FrozenNodes &part = built[shard];
+    merged.resize(part.nodes.size());
+    for (uint32_t node = 0; node < part.nodes.size(); node++) {
+      edges.clear();
+      size_t end = part.edgesEnd(node);
+      for (size_t edge = part.nodes[node] & ~kTerminalBit; edge < end;
+           edge++) {
+        edges.push_back(Edge(part.labels[edge], merged[part.targets[edge]]));
+      }
+      merged[node] =
+          frozen.freeze((part.nodes[node] & kTerminalBit) != 0, edges);
+    }
+    const char *letters = words[shards[shard].first].first;
+    rootEdges.push_back(Edge((unsigned char)letters[0], merged[roots[shard]]));
+  }
+  return frozen.freeze(emptyWord, rootEdges);
+}
+
+CompactLexicon::CompactLexicon() : mapping(nullptr), mappingBytes(0) {
+  build(vector<string>());
+}
+
+CompactLexicon::CompactLexicon(const vector<string> &words)
+    : mapping(nullptr), mappingBytes(0) {
+  build(words);
+}
+
+CompactLexicon::~CompactLexicon() {
+  unmap();
+}
+
+void CompactLexicon::build(vector<string> words, int threads) {
+  vector<WordSpan> spans;
+  spans.reserve(words.size());
+  for (string &word : words) {
+    for (char &ch : word) {
+      ch = char(foldLetter(ch));
+    }
+    spans.push_back(WordSpan(word.data(), word.size()));
+  }
+  build(spans, threads);
+}
+
+/*
+ * Sorts the words unless they already are, as a word list usually is,
+ * drops repeats and builds the DAWG from them.
+ */
+void CompactLexicon::build(vector<WordSpan> &words, int threads) {
+  if (!is_sorted(words.begin(), words.end(), spanLess)) {
+    sort(words.begin(), words.end(), spanLess);
+  }
+  words.erase(unique(words.begin(), words.end(), spanEqual), words.end());
+
+  FrozenNodes frozen;
+  uint32_t newRoot = buildDawg(words, threads, frozen);
+  frozen.nodes.push_back(uint32_t(frozen.labels.size()));
+  unmap();
+  nodeStore.swap(frozen.nodes);
+  labelStore.swap(frozen.labels);
+  targetStore.swap(frozen.targets);
+  nodeStore.shrink_to_fit();
+  labelStore.shrink_to_fit();
+  targetStore.shrink_to_fit();
+  useStores();
+  root = newRoot;
+  baseCount = uint32_t(words.size());
+  added.clear();
+  removed.clear();
+}
+
+void CompactLexicon::useStores() {
+  nodes = nodeStore.data();
+  labels = labelStore.data();
+  targets = targetStore.data();
+  nodeCount = uint32_t(nodeStore.size() - 1);
+  edgeCount = uint32_t(labelStore.size());
+}
+
+void CompactLexicon::unmap() {
+#ifndef _WIN32
+  if (mapping != nullptr) {
+    munmap(mapping, mappingBytes);
+  }
+#endif
+  mapping = nullptr;
+  mappingBytes = 0;
+}
+
+/*
+ * Reads the whole file at once and builds from the lines where they lie
+ * in the buffer, so no word is copied on its own.
+ */
+bool CompactLexicon::addWordsFromFile(const string &path, string &error,
+                                      int threads) {
+  ifstream input(path.c_str(), ios::binary);
+  if (!input) {
+    error = "Couldn't open lexicon file " + path;
+    return false;
+  }
+  input.seekg(0, ios::end);
+  streamoff bytes = input.tellg();
+  input.seekg(0, ios::beg);
+  vector<char> text(bytes > 0 ? size_t(bytes) : 0);
+  if (bytes < 0 || !input.read(text.data(), text.size())) {
+    error = "Couldn't read lexicon file " + path;
+    return false;
+  }
+
+  vector<string> existing(begin(), end());
+  vector<WordSpan> words;
+  words.reserve(existing.size() + count(text.begin(), text.end(), '\n') + 1);
+  for (const string &word : existing) {
+    words.push_back(WordSpan(word.data(), word.size()));
+  }
+  for (size_t start = 0; start < text.size();) {
+    const char *newline =
+        (const char *)memchr(text.data() + start, '\n', text.size() - start);
+    size_t end = newline != nullptr ? newline - text.data() : text.size();
+    size_t first = start, last = end;
+    while (first < last && isLineSpace(text[first])) {
+      first++;
+    }
+    while (last > first && isLineSpace(text[last - 1])) {
+      last--;
+    }
+    if (first < last) {
+      for (size_t i = first; i < last; i++) {
+        text[i] = char(foldLetter(text[i]));
+      }
+      words.push_back(WordSpan(text.data() + first, last - first));
+    }
+    start = end + 1;
+  }
+  build(words, threads);
+  return true;
+}
+
+// follows the edge labelled with letter out of node, if there is one
+bool CompactLexicon::step(unsigned char letter, uint32_t &node) const {
+  uint32_t edge = nodes[node] & ~kTerminal;
+  uint32_t end = nodes[node + 1] & ~kTerminal;
+  while (edge < end && labels[edge] < letter) {
+    edge++;
+  }
+  if (edge == end || labels[edge] != letter) {
+    return false;
+  }
+  node = targets[edge];
+  return true;
+}
+
+/*
+ * Follows the letters from the root, folding them to lower case on the
+ * way, and stores the node reached.  Returns false if some letter has no
+ * edge.
+ */
+bool CompactLexicon::walk(const char *letters, size_t length,
+                          uint32_t &node) const {
+  node = root;
+  for (size_t i = 0; i < length; i++) {
+    if (!step(foldLetter(letters[i]), node)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CompactLexicon::baseContains(const char *word, size_t length) const {
+  uint32_t node;
+  return walk(word, length, node) && (nodes[node] & kTerminal) != 0;
+}
+
+bool CompactLexicon::contains(const char *word) const {
+  return contains(word, strlen(word));
+}
+
+bool CompactLexicon::contains(const char *word, size_t length) const {
+  if (added.empty() && removed.empty()) {
+    return baseContains(word, length);
+  }
+  FoldedKey key = {word, length};
+  if (added.contains(key)) {
+    return true;
+  }
+  return !removed.contains(key) && baseContains(word, length);
+}
+
+/*
+ * Returns true if some word below node, spelled being the letters on the
+ * way to it, hasn't been removed.  Removed words are visited at most once
+ * each, so this stops within removed.size() + 1 words.
+ */
+bool CompactLexicon::hasLiveWord(uint32_t node, string &spelled) const {
+  if ((nodes[node] & kTerminal) && !removed.contains(spelled)) {
+    return true;
+  }
+  uint32_t end = nodes[node + 1] & ~kTerminal;
+  for (uint32_t edge = nodes[node] & ~kTerminal; edge < end; edge++) {
+    spelled.push_back(char(labels[edge]));
+    bool found = hasLiveWord(targets[edge], spelled);
+    spelled.pop_back();
+    if (found) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Returns true if some word starts with prefix, given whether the prefix
+ * could be walked in the DAWG and the node it reached if so.  The prefix
+ * is copied only if some removed word starts with it.
+ */
+bool CompactLexicon::hasLiveWordFrom(const char *prefix, size_t length,
+                                     bool walked, uint32_t node) const {
+  FoldedKey key = {prefix, length};
+  auto next = added.lowerBound(key);
+  if (next != added.end() && compareFolded(*next, prefix, length, true) == 0) {
+    return true;
+  }
+  if (!walked) {
+    return false;
+  }
+  // every node of a DAWG built from words leads to a word
+  next = removed.lowerBound(key);
+  if (next == removed.end() ||
+      compareFolded(*next, prefix, length, true) != 0) {
+    return true;
+  }
+  string spelled(prefix, length);
+  for (char &ch : spelled) {
+    ch = char(foldLetter(ch));
+  }
+  return hasLiveWord(node, spelled);
+}
+
+bool CompactLexicon::containsPrefix(const char *prefix) const {
+  return containsPrefix(prefix, strlen(prefix));
+}
+
+bool CompactLexicon::containsPrefix(const char *prefix, size_t length) const {
+  uint32_t node;
+  bool walked = walk(prefix, length, node);
+  if (added.empty() && removed.empty()) {
+    return walked;
+  }
+  return hasLiveWordFrom(prefix, length, walked, node);
+}
+
+bool CompactLexicon::add(const string &word) {
+  string folded = toLowerCase(word);
+  if (baseContains(folded)) {
+    if (!removed.erase(folded)) {
+      return false;
+    }
+  } else if (!added.insert(folded)) {
+    return false;
+  }
+  compactIfLarge();
+  return true;
+}
+
+bool CompactLexicon::remove(const string &word) {
+  string folded = toLowerCase(word);
+  if (added.erase(folded)) {
+    return true;
+  }
+  if (!baseContains(folded) || !removed.insert(folded)) {
+    return false;
+  }
+  compactIfLarge();
+  return true;
+}
+
+void CompactLexicon::clear() {
+  build(vector<string>());
+}
+
+void CompactLexicon::compactIfLarge() {
+  size_t limit = max(kMinOverlayLimit, size_t(baseCount) / 8);
+  if (added.size() + removed.size() > limit) {
+    compact();
+  }
+}
+
+void CompactLexicon::compact() {
+  if (!added.empty() || !removed.empty()) {
+    build(vector<string>(begin(), end()));
+  }
+}
+
+static void putWord(vector<char> &out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(char((value >> shift) & 0xff));
+  }
+}
+
+static uint32_t getWordAt(const char *in) {
+  uint32_t value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = value << 8 | (unsigned char)in[i];
+  }
+  return value;
+}
+
+static bool isLittleEndian() {
+  uint32_t one = 1;
+  unsigned char first;
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+namespace {
+
+/*
+ * The bytes of a file, mapped into memory if asked and the system
+ * allows it, or else read into a buffer.  The mapping is undone on
+ * destruction unless it has been released to a new owner.
+ */
+struct FileImage {
+  const char *data;
+  size_t bytes;
+  void *mapping;
+  vector<char> buffer;
+
+  FileImage() : data(nullptr), bytes(0), mapping(nullptr) {}
+
+  ~FileImage() {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+      munmap(mapping, bytes);
+    }
+#endif
+  }
+
+  // returns false if the file couldn't be read
+  bool open(const string &path, bool mapIt) {
+#ifndef _WIN32
+    int descriptor = mapIt ? ::open(path.c_str(), O_RDONLY) : -1;
+    struct stat status;
+    if (descriptor >= 0 && fstat(descriptor, &status) == 0 &&
+        status.st_size > 0) {
+      void *mapped = mmap(nullptr, size_t(status.st_size), PROT_READ,
+                          MAP_PRIVATE, descriptor, 0);
+      if (mapped != MAP_FAILED) {
+        mapping = mapped;
+        data = (const char *)mapped;
+        bytes = size_t(status.st_size);
+      }
+    }
+    if (descriptor >= 0) {
+      close(descriptor); // the mapping outlives the descriptor
+    }
+    if (mapping != nullptr) {
+      return true;
+    }
+#else
+    (void)mapIt;
+#endif
+    ifstream file(path.c_str(), ios::binary);
+    if (!file) {
+      return false;
+    }
+    buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    data = buffer.data();
+    bytes = buffer.size();
+    return true;
+  }
+
+  void *release() {
+    void *released = mapping;
+    mapping = nullptr;
+    return released;
+  }
+};
+
+} // namespace
+
+/*
+ * Checks everything lookups rely on in a loaded DAWG, so that a damaged
+ * file can't send them out of bounds or round in circles: edge runs are
+ * in range and in order, labels rise within a run, every edge leads to a
+ * node made earlier, as the builder makes them, and every node leads to
+ * a word.
+ */
+static bool isWellFormedDawg(const uint32_t *nodes,
+                             const unsigned char *labels,
+                             const uint32_t *targets, uint32_t nodeCount,
+                             uint32_t edgeCount, uint32_t root) {
+  if (root >= nodeCount || (nodes[0] & ~kTerminalBit) != 0 ||
+      nodes[nodeCount] != edgeCount) {
+    return false;
+  }
+  vector<bool> leadsToWord(nodeCount);
+  for (uint32_t node = 0; node < nodeCount; node++) {
+    uint32_t first = nodes[node] & ~kTerminalBit;
+    uint32_t end = nodes[node + 1] & ~kTerminalBit;
+    if (end < first || end > edgeCount) {
+      return false;
+    }
+    leadsToWord[node] = (nodes[node] & kTerminalBit) != 0;
+    for (uint32_t edge = first; edge < end; edge++) {
+      if (targets[edge] >= node ||
+          (edge > first && labels[edge] <= labels[edge - 1])) {
+        return false;
+      }
+      if (leadsToWord[targets[edge]]) {
+        leadsToWord[node] = true;
+      }
+    }
+    if (!leadsToWord[node] && node != root) {
+      return false; // only an empty lexicon's root leads nowhere
+    }
+  }
+  return true;
+}
+
+bool CompactLexicon::save(const string &path, string &error) const {
+  if (!added.empty() || !removed.empty()) {
+    CompactLexicon folded(vector<string>(begin(), end()));
+    return folded.save(path, error);
+  }
+  vector<char> out(kMagic, kMagic + sizeof(kMagic));
+  putWord(out, kFormatVersion);
+  putWord(out, nodeCount);
+  putWord(out, edgeCount);
+  putWord(out, root);
+  putWord(out, baseCount);
+  for (uint32_t node = 0; node <= nodeCount; node++) {
+    putWord(out, nodes[node]);
+  }
+  for (uint32_t edge = 0; edge < edgeCount; edge++) {
+    putWord(out, targets[edge]);
+  }
+  out.insert(out.end(), labels, labels + edgeCount);
+
+  // a lexicon loaded from path may still be reading the file where it
+  // lies, so write a new file beside it and rename that over it: the old
+  // file's pages stay as they were until its last mapping is gone
+#ifndef _WIN32
+  string temporary = path + ".tmp" + to_string(getpid());
+#else
+  string temporary = path + ".tmp";
+#endif
+  ofstream file(temporary.c_str(), ios::binary);
+  file.write(out.data(), out.size());
+  file.close();
+  if (!file) {
+    std::remove(temporary.c_str());
+    error = "Could not write the lexicon to " + path;
+    return false;
+  }
+#ifdef _WIN32
+  std::remove(path.c_str()); // rename won't replace a file here
+#endif
+  if (rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    error = "Could not write the lexicon to " + path;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Maps the file where its numbers can be used as they lie, which needs a
+ * little-endian machine, and otherwise reads it and decodes the numbers
+ * into the stores.
+ */
+bool CompactLexicon::load(const string &path, string &error) {
+  FileImage image;
+  if (!image.open(path, isLittleEndian())) {
+    error = "Could not open " + path;
+    return false;
+  }
+  if (image.bytes < kHeaderBytes ||
+      memcmp(image.data, kMagic, sizeof(kMagic)) != 0) {
+    error = path + " is not a saved lexicon";
+    return false;
+  }
+  if (getWordAt(image.data + 4) != kFormatVersion) {
+    error = path + " was saved by another version of this program";
+    return false;
+  }
+  uint32_t savedNodeCount = getWordAt(image.data + 8);
+  uint32_t savedEdgeCount = getWordAt(image.data + 12);
+  uint32_t savedRoot = getWordAt(image.data + 16);
+  uint32_t savedWordCount = getWordAt(image.data + 20);
+  if (image.bytes != kHeaderBytes + 4 * (uint64_t(savedNodeCount) + 1) +
+                         5 * uint64_t(savedEdgeCount)) {
+    error = path + " is damaged";
+    return false;
+  }
+
+  const char *nodeBytes = image.data + kHeaderBytes;
+  const char *targetBytes = nodeBytes + 4 * (size_t(savedNodeCount) + 1);
+  const unsigned char *savedLabels =
+      (const unsigned char *)(targetBytes + 4 * size_t(savedEdgeCount));
+  vector<uint32_t> savedNodeStore, savedTargetStore;
+  const uint32_t *savedNodes, *savedTargets;
+  if (image.mapping != nullptr) {
+    savedNodes = (const uint32_t *)nodeBytes;
+    savedTargets = (const uint32_t *)targetBytes;
+  } else {
+    savedNodeStore.resize(size_t(savedNodeCount) + 1);
+    for (size_t i = 0; i < savedNodeStore.size(); i++) {
+      savedNodeStore[i] = getWordAt(nodeBytes + 4 * i);
+    }
+    savedTargetStore.resize(savedEdgeCount);
+    for (size_t i = 0; i < savedTargetStore.size(); i++) {
+      savedTargetStore[i] = getWordAt(targetBytes + 4 * i);
+    }
+    savedNodes = savedNodeStore.data();
+    savedTargets = savedTargetStore.data();
+  }
+  if (!isWellFormedDawg(savedNodes, savedLabels, savedTargets,
+                        savedNodeCount, savedEdgeCount, savedRoot)) {
+    error = path + " is damaged";
+    return false;
+  }
+
+  unmap();
+  if (image.mapping != nullptr) {
+    vector<uint32_t>().swap(nodeStore);
+    vector<unsigned char>().swap(labelStore);
+    vector<uint32_t>().swap(targetStore);
+    mappingBytes = image.bytes;
+    mapping = image.release();
+    nodes = savedNodes;
+    labels = savedLabels;
+    targets = savedTargets;
+    nodeCount = savedNodeCount;
+    edgeCount = savedEdgeCount;
+  } else {
+    nodeStore.swap(savedNodeStore);
+    labelStore.assign(savedLabels, savedLabels + savedEdgeCount);
+    targetStore.swap(savedTargetStore);
+    useStores();
+  }
+  root = savedRoot;
+  baseCount = savedWordCount;
+  added.clear();
+  removed.clear();
+  return true;
+}
+
+size_t CompactLexicon::getMemoryUsage() const {
+  size_t bytes = nodeStore.capacity() * sizeof(uint32_t) +
+                 labelStore.capacity() +
+                 targetStore.capacity() * sizeof(uint32_t) + mappingBytes;
+  // a string per overlay word, and its letters if they don't fit inside
+  for (const Overlay *overlay : {&added, &removed}) {
+    for (const string &word : *overlay) {
+      bytes += sizeof(string);
+      if (word.capacity() > 15) {
+        bytes += word.capacity() + 1;
+      }
+    }
+  }
+  return bytes;
+}
+
+CompactLexicon::iterator::iterator(const CompactLexicon *lexicon)
+    : lexicon(lexicon), baseDone(false), nextAdded(lexicon->added.begin()),
+      done(false) {
+  uint32_t root = lexicon->root;
+  path.push_back(make_pair(root, lexicon->nodes[root] & ~kTerminal));
+  bool empty = (lexicon->nodes[root] & kTerminal) != 0;
+  if (!empty || lexicon->removed.contains(spelled)) {
+    advanceBase();
+  }
+  advance();
+}
+
+/*
+ * Moves spelled on to the next word of the DAWG that hasn't been removed,
+ * depth first, which visits words in alphabetical order because each
+ * node's edges are sorted.
+ */
+void CompactLexicon::iterator::advanceBase() {
+  const uint32_t *nodes = lexicon->nodes;
+  while (!path.empty()) {
+    pair<uint32_t, uint32_t> &top = path.back();
+    if (top.second == (nodes[top.first + 1] & ~kTerminal)) {
+      path.pop_back();
+      if (!path.empty()) {
+        spelled.pop_back();
+      }
+      continue;
+    }
+    uint32_t edge = top.second++;
+    uint32_t child = lexicon->targets[edge];
+    spelled.push_back(char(lexicon->labels[edge]));
+    path.push_back(make_pair(child, nodes[child] & ~kTerminal));
+    if ((nodes[child] & kTerminal) && !lexicon->removed.contains(spelled)) {
+      return;
+    }
+  }
+  baseDone = true;
+}
+
+// takes whichever of the next DAWG word and the next added word is first
+void CompactLexicon::iterator::advance() {
+  bool addedDone = nextAdded == lexicon->added.end();
+  if (baseDone && addedDone) {
+    done = true;
+    current.clear();
+  } else if (!baseDone && (addedDone || spelled < *nextAdded)) {
+    current = spelled;
+    advanceBase();
+  } else {
+    current = *nextAdded;
+    ++nextAdded;
+  }
+}
+
+// the overlay, if there is one, is fixed for the cursor's life
+CompactLexicon::Cursor::Cursor(const CompactLexicon *lexicon)
+    : lexicon(lexicon), node(lexicon->root), onBase(true) {}
+
+bool CompactLexicon::Cursor::advance(char letter) {
+  if (lexicon == nullptr) {
+    return false;
+  }
+  unsigned char folded = foldLetter(letter);
+  uint32_t next = node;
+  bool walked = onBase && lexicon->step(folded, next);
+  if (lexicon->added.empty() && lexicon->removed.empty()) {
+    if (walked) {
+      node = next;
+    }
+    return walked;
+  }
+  spelled.push_back(char(folded));
+  if (!lexicon->hasLiveWordFrom(spelled.data(), spelled.size(), walked,
+                                next)) {
+    spelled.pop_back();
+    return false;
+  }
+  node = next;
+  onBase = walked;
+  return true;
+}
+
+bool CompactLexicon::Cursor::isWord() const {
+  if (lexicon == nullptr) {
+    return false;
+  }
+  bool inBase = onBase && (lexicon->nodes[node] & kTerminal) != 0;
+  if (lexicon->added.empty() && lexicon->removed.empty()) {
+    return inBase;
+  }
+  if (lexicon->added.contains(spelled)) {
+    return true;
+  }
+  return inBase && !lexicon->removed.contains(spelled);
+}
+
+bool CompactLexicon::Cursor::hasChildren() const {
+  if (lexicon == nullptr) {
+    return false;
+  }
+  const uint32_t *nodes = lexicon->nodes;
+  uint32_t first = nodes[node] & ~kTerminal;
+  uint32_t end = nodes[node + 1] & ~kTerminal;
+  if (lexicon->added.empty() && lexicon->removed.empty()) {
+    return onBase && first < end;
+  }
+  // the first added word after the prefix is longer if it starts with it
+  auto next = lexicon->added.upperBound(spelled);
+  if (next != lexicon->added.end() && next->compare(0, spelled.size(),
+                                                    spelled) == 0) {
+    return true;
+  }
+  string longer = spelled;
+  for (uint32_t edge = first; onBase && edge < end; edge++) {
+    longer.push_back(char(lexicon->labels[edge]));
+    if (lexicon->hasLiveWord(lexicon->targets[edge], longer)) {
+      return true;
+    }
+    longer.pop_back();
+  }
+  return false;
+}
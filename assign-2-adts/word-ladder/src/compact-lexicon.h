@@ -0,0 +1,307 @@
+/**
+ * File: compact-lexicon.h
+ * -----------------------
+ * Defines CompactLexicon, a word list with the same lookups as the
+ * Stanford Lexicon in a small fraction of its memory.
+ *
+ * The words are stored as a minimized DAWG, a trie in which identical
+ * subtrees are shared, so "walking", "talking" and "balking" all end in
+ * the same "alking" nodes.  Each node is a run of edges sorted by letter
+ * in flat arrays, 5 bytes per edge and 4 per node, with no pointers and
+ * no second copy of the words for iteration: words come out in order by
+ * walking the edges.  The 127k words of dictionary.txt take well under
+ * a megabyte.
+ *
+ * A DAWG can't be changed in place, so words added or removed after it
+ * is built are kept in a small overlay, consulted on every lookup, and
+ * folded into a rebuilt DAWG once the overlay grows past a fraction of
+ * the lexicon, or whenever compact is called.
+ *
+ * A lexicon can be saved in a binary file and loaded from it again.  On
+ * most machines loading maps the file into memory and queries it where
+ * it lies, so startup reads no words and allocates nothing per word, and
+ * processes sharing the file share its pages.
+ *
+ * Like the Stanford Lexicon, words are case-insensitive and stored in
+ * lower case.  Lookups fold case letter by letter as they walk, so none
+ * of them allocates, and a Cursor walks the DAWG one letter at a time for
+ * callers that test many words sharing a prefix.  Nothing here depends
+ * on the Stanford library.
+ */
+
+#ifndef _compact_lexicon_
+#define _compact_lexicon_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CompactLexicon {
+  /*
+   * The letters of a lookup, compared with the overlay's lower-case words
+   * as though folded to lower case first, so the overlay can be searched
+   * without copying them.
+   */
+  struct FoldedKey {
+    const char *letters;
+    size_t length;
+  };
+  struct OverlayOrder {
+    bool operator()(const std::string &word, const FoldedKey &key) const;
+  };
+
+  /*
+   * The words added or removed since the DAWG was built, lower case and
+   * in order in a vector.  std::lower_bound searches it by FoldedKey,
+   * which std::set can't do before C++14, and the overlay never grows
+   * past a fraction of the lexicon, so inserting in the middle is cheap.
+   */
+  class Overlay {
+  public:
+    typedef std::vector<std::string>::const_iterator const_iterator;
+    const_iterator begin() const { return words.begin(); }
+    const_iterator end() const { return words.end(); }
+    size_t size() const { return words.size(); }
+    bool empty() const { return words.empty(); }
+    void clear() { words.clear(); }
+
+    bool contains(const std::string &word) const;
+    bool contains(const FoldedKey &key) const;
+    // the first word not before key, and the first word after word
+    const_iterator lowerBound(const FoldedKey &key) const;
+    const_iterator upperBound(const std::string &word) const;
+    // return false if word was already there, or wasn't
+    bool insert(const std::string &word);
+    bool erase(const std::string &word);
+
+  private:
+    std::vector<std::string> words;
+  };
+
+public:
+  /**
+   * Creates an empty lexicon.
+   */
+  CompactLexicon();
+
+  /**
+   * Creates a lexicon holding the given words, in any order.
+   */
+  explicit CompactLexicon(const std::vector<std::string> &words);
+
+  ~CompactLexicon();
+
+  /**
+   * Replaces the contents with the given words, which may come in any
+   * order and may repeat, built by the given number of threads, 0
+   * meaning one per hardware thread.  Words already in order, as in most
+   * word lists, skip the sort and are built in a single pass.
+   */
+  void build(std::vector<std::string> words, int threads = 0);
+
+  /**
+   * Writes the lexicon, overlay included, to a binary file at path,
+   * replacing any file there in one step, so lexicons already loaded
+   * from it, in this process or another, go on reading the old one.
+   * Returns false and describes the problem in error if it could not be
+   * written.
+   */
+  bool save(const std::string &path, std::string &error) const;
+
+  /**
+   * Replaces the contents with the lexicon saved in the file at path,
+   * mapping the file into memory where the system allows it.  Returns
+   * false, leaving the lexicon as it was, and describes the problem in
+   * error if the file is missing, from another version or damaged.
+   */
+  bool load(const std::string &path, std::string &error);
+
+  /**
+   * Adds the words in the text file at path, one per line, to the
+   * lexicon, building with the given number of threads as build does.
+   * Returns false and describes the problem in error if the file could
+   * not be read.
+   */
+  bool addWordsFromFile(const std::string &path, std::string &error,
+                        int threads = 0);
+
+  /**
+   * Adds word to the lexicon.  Returns false if it was already there.
+   */
+  bool add(const std::string &word);
+
+  /**
+   * Removes word from the lexicon.  Returns false if it wasn't there.
+   */
+  bool remove(const std::string &word);
+
+  /**
+   * Returns true if the word, of the given length or else ending at the
+   * first null character, is in the lexicon.
+   */
+  bool contains(const std::string &word) const {
+    return contains(word.data(), word.size());
+  }
+  bool contains(const char *word) const;
+  bool contains(const char *word, size_t length) const;
+
+  /**
+   * Returns true if some word in the lexicon starts with prefix.
+   */
+  bool containsPrefix(const std::string &prefix) const {
+    return containsPrefix(prefix.data(), prefix.size());
+  }
+  bool containsPrefix(const char *prefix) const;
+  bool containsPrefix(const char *prefix, size_t length) const;
+
+  int size() const { return int(baseCount - removed.size() + added.size()); }
+  bool isEmpty() const { return size() == 0; }
+  void clear();
+
+  /**
+   * Folds any added or removed words into the DAWG.
+   */
+  void compact();
+
+  /**
+   * Returns the number of bytes the lexicon's arrays hold, whether built
+   * or mapped from a file, overlay included, for comparison with other
+   * representations.
+   */
+  size_t getMemoryUsage() const;
+
+  int getNodeCount() const { return int(nodeCount); }
+  int getEdgeCount() const { return int(edgeCount); }
+
+  /**
+   * Iterates over the words in alphabetical order.  Any change to the
+   * lexicon invalidates its iterators.
+   */
+  class iterator : public std::iterator<std::input_iterator_tag, std::string> {
+  public:
+    iterator() : lexicon(nullptr), baseDone(true), done(true) {}
+    const std::string &operator*() const { return current; }
+    const std::string *operator->() const { return &current; }
+    iterator &operator++() {
+      advance();
+      return *this;
+    }
+    bool operator==(const iterator &rhs) const {
+      return done == rhs.done && (done || current == rhs.current);
+    }
+    bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+
+  private:
+    friend class CompactLexicon;
+    explicit iterator(const CompactLexicon *lexicon);
+
+    const CompactLexicon *lexicon;
+    std::vector<std::pair<uint32_t, uint32_t>> path; // (node, next edge)
+    std::string spelled;                             // letters along path
+    bool baseDone;
+    Overlay::const_iterator nextAdded;
+    std::string current;
+    bool done;
+
+    void advanceBase();
+    void advance();
+  };
+
+  iterator begin() const { return iterator(this); }
+  iterator end() const { return iterator(); }
+
+  /**
+   * Spells out a prefix one letter at a time from the start of the
+   * lexicon's words.  Copying a cursor is cheap, so testing every letter
+   * in one position of a word needs only one walk to that position:
+   *
+   *     CompactLexicon::Cursor stem = english.getCursor();
+   *     stem.advance('c');
+   *     for (char letter = 'a'; letter <= 'z'; letter++) {
+   *       CompactLexicon::Cursor word = stem;
+   *       if (word.advance(letter) && word.advance('t') && word.isWord())
+   *         ...
+   *     }
+   *
+   * Any change to the lexicon invalidates its cursors.
+   */
+  class Cursor {
+  public:
+    Cursor() : lexicon(nullptr), node(0), onBase(false) {}
+
+    /**
+     * Appends letter to the prefix and returns true if some word starts
+     * with the result, or returns false and leaves the cursor as it was.
+     */
+    bool advance(char letter);
+
+    /**
+     * Returns true if the prefix spelled so far is itself a word.
+     */
+    bool isWord() const;
+
+    /**
+     * Returns true if some word is longer than the prefix and starts
+     * with it.
+     */
+    bool hasChildren() const;
+
+  private:
+    friend class CompactLexicon;
+    explicit Cursor(const CompactLexicon *lexicon);
+
+    const CompactLexicon *lexicon;
+    uint32_t node; // the DAWG node the prefix leads to, if onBase
+    bool onBase;   // false once the prefix leaves the DAWG for the overlay
+    std::string spelled; // the prefix, kept only if there is an overlay
+  };
+
+  Cursor getCursor() const { return Cursor(this); }
+
+private:
+  // nodes[i] is the index of node i's first edge, with kTerminal set if a
+  // word ends at node i; node i's edges end where node i + 1's begin, and
+  // a final entry marks where the last node's edges end
+  const uint32_t *nodes;
+  const unsigned char *labels; // the letter on each edge
+  const uint32_t *targets;     // the node each edge leads to
+  uint32_t nodeCount;
+  uint32_t edgeCount;
+  uint32_t root;
+
+  // the arrays above point into these, or else into a mapped file
+  std::vector<uint32_t> nodeStore;
+  std::vector<unsigned char> labelStore;
+  std::vector<uint32_t> targetStore;
+  void *mapping;
+  size_t mappingBytes;
+
+  uint32_t baseCount; // words in the DAWG, removed ones included
+  Overlay added;      // words not in the DAWG
+  Overlay removed;    // words in the DAWG that are gone
+
+  static const uint32_t kTerminal = 0x80000000;
+
+  bool baseContains(const std::string &word) const {
+    return baseContains(word.data(), word.size());
+  }
+  bool baseContains(const char *word, size_t length) const;
+  bool walk(const char *letters, size_t length, uint32_t &node) const;
+  bool step(unsigned char letter, uint32_t &node) const;
+  bool hasLiveWord(uint32_t node, std::string &spelled) const;
+  bool hasLiveWordFrom(const char *prefix, size_t length, bool walked,
+                       uint32_t node) const;
+  void compactIfLarge();
+  void build(std::vector<std::pair<const char *, size_t>> &words,
+             int threads);
+  void useStores();
+  void unmap();
+
+  CompactLexicon(const CompactLexicon &original);
+  void operator=(const CompactLexicon &rhs) const;
+};
+
+#endif
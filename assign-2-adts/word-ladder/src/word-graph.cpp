@@ -0,0 +1,333 @@
+/**
+ * File: word-graph.cpp
+ * --------------------
+ * Implements the word graph.
+ *
+ * Saved graphs are little-endian whatever the machine, laid out as
+ *
+ *   "WGRF", version, fingerprint (8 bytes), word count n, text bytes,
+ *   edge count, starts (n + 1 words), text, edgeStarts (n + 1 words),
+ *   edges
+ *
+ * where every number is 4 bytes unless marked otherwise.
+ */
+
+#include "word-graph.h"
+
+#include <algorithm> // for is_sorted, sort, unique
+#include <atomic>
+#include <cstdio>    // for remove, rename
+#include <cstring>   // for memcmp
+#include <fstream>
+#include <iterator>  // for istreambuf_iterator
+#include <thread>
+#include <utility>   // for pair
+#ifndef _WIN32
+#include <unistd.h>  // for getpid
+#endif
+using namespace std;
+
+// bump whenever the layout of saved graphs changes
+static const uint32_t kFormatVersion = 1;
+static const char kMagic[4] = {'W', 'G', 'R', 'F'};
+
+WordGraph::WordGraph() : starts(1, 0), edgeStarts(1, 0), fingerprint(0) {}
+
+uint64_t WordGraph::fingerprintOf(const vector<string> &words) {
+  // FNV-1a, with each word's terminating newline hashed too
+  uint64_t hash = 14695981039346656037ULL;
+  for (const string &word : words) {
+    for (char ch : word) {
+      hash = (hash ^ (unsigned char)ch) * 1099511628211ULL;
+    }
+    hash = (hash ^ '\n') * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/*
+ * Finds every pair of words of one length that differ only at one
+ * position, by sorting the words on their letters with that position
+ * left out: each run of equal keys is then one wildcard group.
+ */
+static void groupByPattern(const vector<char> &text,
+                           const vector<uint32_t> &starts,
+                           vector<uint32_t> ids, size_t length,
+                           size_t position,
+                           vector<pair<uint32_t, uint32_t>> &found) {
+  const char *base = text.data();
+  auto samePattern = [&](uint32_t one, uint32_t two) {
+    const char *a = base + starts[one], *b = base + starts[two];
+    return memcmp(a, b, position) == 0 &&
+           memcmp(a + position + 1, b + position + 1,
+                  length - position - 1) == 0;
+  };
+  sort(ids.begin(), ids.end(), [&](uint32_t one, uint32_t two) {
+    const char *a = base + starts[one], *b = base + starts[two];
+    int order = memcmp(a, b, position);
+    if (order == 0) {
+      order = memcmp(a + position + 1, b + position + 1,
+                     length - position - 1);
+    }
+    return order < 0;
+  });
+  size_t first = 0;
+  while (first < ids.size()) {
+    size_t end = first + 1;
+    while (end < ids.size() && samePattern(ids[first], ids[end])) {
+      end++;
+    }
+    for (size_t i = first; i < end; i++) {
+      for (size_t j = first; j < end; j++) {
+        if (i != j) {
+          found.push_back(make_pair(ids[i], ids[j]));
+        }
+      }
+    }
+    first = end;
+  }
+}
+
+void WordGraph::build(const vector<string> &words, int threads) {
+  fingerprint = fingerprintOf(words);
+  vector<string> sorted = words;
+  if (!is_sorted(sorted.begin(), sorted.end())) {
+    sort(sorted.begin(), sorted.end());
+  }
+  sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+  uint32_t count = uint32_t(sorted.size());
+
+  text.clear();
+  starts.assign(1, 0);
+  vector<vector<uint32_t>> byLength;
+  for (uint32_t id = 0; id < count; id++) {
+    const string &word = sorted[id];
+    text.insert(text.end(), word.begin(), word.end());
+    starts.push_back(uint32_t(text.size()));
+    if (byLength.size() <= word.size()) {
+      byLength.resize(word.size() + 1);
+    }
+    byLength[word.size()].push_back(id);
+  }
+
+  // one task per (length, position), largest lengths first
+  vector<pair<size_t, size_t>> tasks;
+  for (size_t length = 1; length < byLength.size(); length++) {
+    if (byLength[length].size() > 1) {
+      for (size_t position = 0; position < length; position++) {
+        tasks.push_back(make_pair(length, position));
+      }
+    }
+  }
+  sort(tasks.begin(), tasks.end(),
+       [&](const pair<size_t, size_t> &one, const pair<size_t, size_t> &two) {
+         return byLength[one.first].size() > byLength[two.first].size();
+       });
+  vector<vector<pair<uint32_t, uint32_t>>> found(tasks.size());
+  atomic<size_t> nextTask(0);
+  auto work = [&] {
+    while (true) {
+      size_t task = nextTask++;
+      if (task >= tasks.size()) {
+        return;
+      }
+      size_t length = tasks[task].first;
+      groupByPattern(text, starts, byLength[length], length,
+                     tasks[task].second, found[task]);
+    }
+  };
+  if (threads <= 0) {
+    threads = max(1, int(thread::hardware_concurrency()));
+  }
+  threads = min(threads, max(1, int(tasks.size())));
+  vector<thread> workers;
+  for (int i = 1; i < threads; i++) {
+    workers.push_back(thread(work));
+  }
+  work();
+  for (thread &worker : workers) {
+    worker.join();
+  }
+
+  // words differing at one position share exactly one group, so no
+  // pair is found twice
+  edgeStarts.assign(count + 1, 0);
+  for (const auto &pairs : found) {
+    for (const auto &edge : pairs) {
+      edgeStarts[edge.first + 1]++;
+    }
+  }
+  for (uint32_t id = 0; id < count; id++) {
+    edgeStarts[id + 1] += edgeStarts[id];
+  }
+  edges.resize(edgeStarts[count]);
+  vector<uint32_t> filled(edgeStarts.begin(), edgeStarts.end() - 1);
+  for (const auto &pairs : found) {
+    for (const auto &edge : pairs) {
+      edges[filled[edge.first]++] = edge.second;
+    }
+  }
+  for (uint32_t id = 0; id < count; id++) {
+    sort(edges.begin() + edgeStarts[id], edges.begin() + edgeStarts[id + 1]);
+  }
+}
+
+int WordGraph::find(const string &word) const {
+  // words are numbered alphabetically, so a binary search finds them
+  int low = 0, high = size();
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    uint32_t length = starts[middle + 1] - starts[middle];
+    int order = word.compare(0, string::npos, text.data() + starts[middle],
+                             length);
+    if (order == 0) {
+      return middle;
+    }
+    if (order < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return -1;
+}
+
+string WordGraph::getWord(int id) const {
+  return string(text.data() + starts[id], starts[id + 1] - starts[id]);
+}
+
+static void putWord(vector<char> &out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(char((value >> shift) & 0xff));
+  }
+}
+
+static void putWords(vector<char> &out, const vector<uint32_t> &values) {
+  for (uint32_t value : values) {
+    putWord(out, value);
+  }
+}
+
+static uint32_t getWordAt(const char *in) {
+  uint32_t value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = value << 8 | (unsigned char)in[i];
+  }
+  return value;
+}
+
+// true if values is nondecreasing, starts at 0 and ends at last
+static bool isOffsetTable(const vector<uint32_t> &values, uint32_t last) {
+  if (values.empty() || values.front() != 0 || values.back() != last) {
+    return false;
+  }
+  for (size_t i = 1; i < values.size(); i++) {
+    if (values[i] < values[i - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WordGraph::save(const string &path, string &error) const {
+  vector<char> out(kMagic, kMagic + sizeof(kMagic));
+  putWord(out, kFormatVersion);
+  putWord(out, uint32_t(fingerprint));
+  putWord(out, uint32_t(fingerprint >> 32));
+  putWord(out, uint32_t(size()));
+  putWord(out, uint32_t(text.size()));
+  putWord(out, uint32_t(edges.size()));
+  putWords(out, starts);
+  out.insert(out.end(), text.begin(), text.end());
+  putWords(out, edgeStarts);
+  putWords(out, edges);
+
+  // another run may be loading the graph while this one saves it, and a
+  // write cut short would leave a graph that fails to load, so the new
+  // graph is written beside the old one and renamed over it when whole
+#ifndef _WIN32
+  string temporary = path + ".tmp" + to_string(getpid());
+#else
+  string temporary = path + ".tmp";
+#endif
+  ofstream file(temporary.c_str(), ios::binary);
+  file.write(out.data(), out.size());
+  file.close();
+  if (!file) {
+    remove(temporary.c_str());
+    error = "Could not write the word graph to " + path;
+    return false;
+  }
+#ifdef _WIN32
+  remove(path.c_str()); // rename won't replace a file here
+#endif
+  if (rename(temporary.c_str(), path.c_str()) != 0) {
+    remove(temporary.c_str());
+    error = "Could not write the word graph to " + path;
+    return false;
+  }
+  return true;
+}
+
+bool WordGraph::load(const string &path, string &error) {
+  ifstream file(path.c_str(), ios::binary);
+  if (!file) {
+    error = "Could not open " + path;
+    return false;
+  }
+  vector<char> in((istreambuf_iterator<char>(file)),
+                  istreambuf_iterator<char>());
+  const size_t kHeaderBytes = 28;
+  if (in.size() < kHeaderBytes || memcmp(in.data(), kMagic, 4) != 0) {
+    error = path + " is not a saved word graph";
+    return false;
+  }
+  if (getWordAt(&in[4]) != kFormatVersion) {
+    error = path + " was saved by another version of this program";
+    return false;
+  }
+  uint64_t savedFingerprint =
+      getWordAt(&in[8]) | uint64_t(getWordAt(&in[12])) << 32;
+  uint64_t count = getWordAt(&in[16]);
+  uint64_t textBytes = getWordAt(&in[20]);
+  uint64_t edgeCount = getWordAt(&in[24]);
+  if (in.size() != kHeaderBytes + 4 * (count + 1) + textBytes +
+                       4 * (count + 1) + 4 * edgeCount) {
+    error = path + " is damaged";
+    return false;
+  }
+
+  const char *cursor = in.data() + kHeaderBytes;
+  vector<uint32_t> savedStarts(count + 1), savedEdgeStarts(count + 1);
+  vector<uint32_t> savedEdges(edgeCount);
+  for (uint32_t &value : savedStarts) {
+    value = getWordAt(cursor);
+    cursor += 4;
+  }
+  vector<char> savedText(cursor, cursor + textBytes);
+  cursor += textBytes;
+  for (uint32_t &value : savedEdgeStarts) {
+    value = getWordAt(cursor);
+    cursor += 4;
+  }
+  for (uint32_t &value : savedEdges) {
+    value = getWordAt(cursor);
+    cursor += 4;
+    if (value >= count) {
+      error = path + " is damaged";
+      return false;
+    }
+  }
+  if (!isOffsetTable(savedStarts, uint32_t(textBytes)) ||
+      !isOffsetTable(savedEdgeStarts, uint32_t(edgeCount))) {
+    error = path + " is damaged";
+    return false;
+  }
+
+  text.swap(savedText);
+  starts.swap(savedStarts);
+  edgeStarts.swap(savedEdgeStarts);
+  edges.swap(savedEdges);
+  fingerprint = savedFingerprint;
+  return true;
+}
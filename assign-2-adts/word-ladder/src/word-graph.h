@@ -0,0 +1,107 @@
+/**
+ * File: word-graph.h
+ * ------------------
+ * Defines a precomputed graph of the words in a dictionary, in which two
+ * words are neighbours if they have the same length and differ in exactly
+ * one letter, so a word ladder search can find every step from a word in
+ * time proportional to the number of steps rather than by trying all 26
+ * letters in every position against the dictionary.
+ *
+ * The graph is built by grouping the words of each length by wildcard
+ * pattern: "cat" belongs to the groups "*at", "c*t" and "ca*", and the
+ * members of a group are all neighbours of one another.  Every (length,
+ * position) pair is grouped independently, so the work is spread across
+ * threads.  The finished graph can be saved to a file and loaded by later
+ * runs in a fraction of the time it takes to build.
+ *
+ * Nothing here depends on the Stanford library.
+ */
+
+#ifndef _word_graph_
+#define _word_graph_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class WordGraph {
+public:
+  /**
+   * Creates an empty graph.
+   */
+  WordGraph();
+
+  /**
+   * Replaces the graph with one over the given words, which may come in
+   * any order and may repeat, built by the given number of threads, 0
+   * meaning one per hardware thread.  Words are numbered in alphabetical
+   * order.
+   */
+  void build(const std::vector<std::string> &words, int threads = 0);
+
+  /**
+   * Returns the number of distinct words in the graph.
+   */
+  int size() const { return int(starts.size()) - 1; }
+
+  /**
+   * Returns the number of the given word, or -1 if it isn't in the graph.
+   */
+  int find(const std::string &word) const;
+
+  /**
+   * Returns the word with the given number.
+   */
+  std::string getWord(int id) const;
+
+  /**
+   * Returns the length of the word with the given number, and a pointer
+   * to its letters, which are not followed by a null character.
+   */
+  int getLength(int id) const { return int(starts[id + 1] - starts[id]); }
+  const char *getLetters(int id) const { return text.data() + starts[id]; }
+
+  /**
+   * Returns the number of neighbours of the word with the given number,
+   * and a pointer to their numbers, in increasing order.
+   */
+  int degree(int id) const { return int(edgeStarts[id + 1] - edgeStarts[id]); }
+  const uint32_t *neighbours(int id) const {
+    return edges.data() + edgeStarts[id];
+  }
+
+  /**
+   * Returns a hash of the word list the graph was built from, so that a
+   * saved graph can be checked against the dictionary it should match.
+   */
+  uint64_t getFingerprint() const { return fingerprint; }
+
+  /**
+   * Returns the hash of a word list that getFingerprint returns once a
+   * graph is built from it.
+   */
+  static uint64_t fingerprintOf(const std::vector<std::string> &words);
+
+  /**
+   * Writes the graph to the file at path, replacing any file there only
+   * once the whole graph is written.  Returns false and describes the
+   * problem in error if it could not be written.
+   */
+  bool save(const std::string &path, std::string &error) const;
+
+  /**
+   * Replaces the graph with the one saved in the file at path.  Returns
+   * false, leaving the graph as it was, and describes the problem in
+   * error if the file is missing, from another version or damaged.
+   */
+  bool load(const std::string &path, std::string &error);
+
+private:
+  std::vector<char> text;           // every word, one after another
+  std::vector<uint32_t> starts;     // word i is text[starts[i], starts[i + 1])
+  std::vector<uint32_t> edgeStarts; // neighbours of word i, likewise
+  std::vector<uint32_t> edges;
+  uint64_t fingerprint;
+};
+
+#endif
@@ -0,0 +1,430 @@
+/**
+ * File: word-ladder-solver.cpp
+ * ----------------------------
+ * Implements the word ladder solver.
+ */
+
+#include "word-ladder-solver.h"
+
+#include <algorithm>  // for push_heap, pop_heap, reverse, find, equal, min
+#include <cctype>     // for tolower
+#include <climits>    // for UINT32_MAX
+#include <functional> // for greater
+using namespace std;
+
+WordLadderSolver::WordLadderSolver(const WordGraph &graph)
+    : graph(graph), words(0), stamp(0), expanded(0) {}
+
+/*
+ * Resizes the scratch space if the graph has changed size, starts a new
+ * stamp and checks the endpoints.  Returns false if either isn't a word
+ * or they differ in length, since then no ladder can join them.
+ */
+bool WordLadderSolver::begin(int from, int to, vector<int> &ladder) {
+  ladder.clear();
+  expanded = 0;
+  if (uint32_t(graph.size()) != words) {
+    words = uint32_t(graph.size());
+    seen.assign(words, 0);
+    parent.resize(words);
+    distance.resize(words);
+    queue.resize(words);
+    stamp = 0;
+  }
+  // solveBidirectional tags the words reached from each end with its own
+  // number, stamp and stamp + 1
+  stamp += 2;
+  if (stamp == 0) {
+    seen.assign(words, 0);
+    stamp = 2;
+  }
+  return from >= 0 && to >= 0 && uint32_t(from) < words &&
+         uint32_t(to) < words && graph.getLength(from) == graph.getLength(to);
+}
+
+/*
+ * Returns the number of positions in which the words numbered word and
+ * to differ, which must have the same length.  One step changes one
+ * letter, so this never overestimates the steps left and changes by at
+ * most one per step.
+ */
+int WordLadderSolver::lettersToChange(int word, int to) const {
+  const char *one = graph.getLetters(word), *two = graph.getLetters(to);
+  int length = graph.getLength(word), count = 0;
+  for (int i = 0; i < length; i++) {
+    count += one[i] != two[i];
+  }
+  return count;
+}
+
+/*
+ * Follows the parent links from word to the word its search started
+ * from, storing each word in the slot before the last, so the ladder
+ * ends just before end and starts distance[word] words earlier.
+ */
+void WordLadderSolver::trace(int word, int *end) const {
+  for (; word != -1; word = parent[word]) {
+    *--end = word;
+  }
+}
+
+/*
+ * Searches breadth first from from, which begin has checked, without
+ * entering any of the blocked words or stepping straight from from to
+ * any of the banned ones, and stops as soon as it reaches to.  Both
+ * lists are short, so they are marked or scanned rather than hashed.
+ */
+bool WordLadderSolver::search(int from, int to, const vector<int> &blocked,
+                              const vector<int> &banned,
+                              vector<int> &ladder) {
+  for (int word : blocked) {
+    seen[word] = stamp;
+  }
+  seen[from] = stamp;
+  parent[from] = -1;
+  distance[from] = 0;
+  bool found = from == to;
+  queue[0] = from;
+  uint32_t head = 0, tail = 1;
+  while (head < tail && !found) {
+    int word = queue[head++];
+    expanded++;
+    const uint32_t *neighbours = graph.neighbours(word);
+    int degree = graph.degree(word);
+    for (int i = 0; i < degree; i++) {
+      int next = int(neighbours[i]);
+      if (seen[next] == stamp ||
+          (word == from && std::find(banned.begin(), banned.end(), next) !=
+                               banned.end())) {
+        continue;
+      }
+      seen[next] = stamp;
+      parent[next] = word;
+      distance[next] = distance[word] + 1;
+      if (next == to) {
+        found = true;
+        break;
+      }
+      queue[tail++] = next;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  ladder.resize(distance[to] + 1);
+  trace(to, ladder.data() + ladder.size());
+  return true;
+}
+
+bool WordLadderSolver::solveBreadthFirst(int from, int to,
+                                         vector<int> &ladder) {
+  static const vector<int> none;
+  return begin(from, to, ladder) && search(from, to, none, none, ladder);
+}
+
+/*
+ * Short words branch widely: in dictionary.txt a three-letter word has
+ * 16 neighbours on average and a four-letter word 11, so each step can
+ * multiply the words reached about tenfold, and two searches that each
+ * go halfway reach far fewer words than one that goes all the way.
+ * Each round extends whichever end has fewer words waiting by every
+ * word at its current distance, so a common word with many neighbours
+ * is left to the other end where possible.  Neighbourhoods are
+ * symmetric, so the backward search uses the same lists.  Both ends
+ * keep their words in the one queue, from opposite ends of it, since no
+ * word is reached by both.  A round that finds the other side may find
+ * it through several words, and only the shortest join over the whole
+ * round is kept.
+ */
+bool WordLadderSolver::solveBidirectional(int from, int to,
+                                          vector<int> &ladder) {
+  if (!begin(from, to, ladder)) {
+    return false;
+  }
+  uint32_t forward = stamp, backward = stamp + 1;
+  seen[from] = forward;
+  parent[from] = -1;
+  distance[from] = 0;
+  if (from == to) {
+    expanded = 1;
+    ladder.assign(1, from);
+    return true;
+  }
+  seen[to] = backward;
+  parent[to] = -1;
+  distance[to] = 0;
+  queue[0] = from;
+  queue[words - 1] = to;
+  uint32_t frontHead = 0, frontTail = 1;           // forward is [head, tail)
+  uint32_t backHead = words, backTail = words - 1; // backward is [tail, head)
+
+  while (frontHead < frontTail && backTail < backHead) {
+    bool fromFront = frontTail - frontHead <= backHead - backTail;
+    uint32_t mine = fromFront ? forward : backward;
+    uint32_t theirs = fromFront ? backward : forward;
+    uint32_t best = UINT32_MAX;
+    int meetMine = 0, meetTheirs = 0;
+    uint32_t levelEnd = fromFront ? frontTail : backTail;
+    while (fromFront ? frontHead < levelEnd : backHead > levelEnd) {
+      int word = fromFront ? queue[frontHead++] : queue[--backHead];
+      expanded++;
+      const uint32_t *neighbours = graph.neighbours(word);
+      int degree = graph.degree(word);
+      for (int i = 0; i < degree; i++) {
+        int next = int(neighbours[i]);
+        if (seen[next] == theirs) {
+          uint32_t length = distance[word] + 1 + distance[next];
+          if (length < best) {
+            best = length;
+            meetMine = word;
+            meetTheirs = next;
+          }
+        } else if (seen[next] != mine) {
+          seen[next] = mine;
+          parent[next] = word;
+          distance[next] = distance[word] + 1;
+          if (fromFront) {
+            queue[frontTail++] = next;
+          } else {
+            queue[--backTail] = next;
+          }
+        }
+      }
+    }
+    if (best != UINT32_MAX) {
+      int meetFront = fromFront ? meetMine : meetTheirs;
+      int meetBack = fromFront ? meetTheirs : meetMine;
+      ladder.resize(best + 1);
+      trace(meetFront, ladder.data() + distance[meetFront] + 1);
+      // the backward half comes out destination first, so reverse it
+      int *half = ladder.data() + distance[meetFront] + 1;
+      trace(meetBack, half + distance[meetBack] + 1);
+      reverse(half, half + distance[meetBack] + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * A word differing from the destination in h letters needs at least h
+ * more steps, and one step alters h by at most one, so a word's distance
+ * is settled when A* first takes it from the heap; an entry whose
+ * estimate no longer matches was pushed before a shorter route was found
+ * and is passed over.  Hamming distance is a weak guide in a sparse word
+ * graph, since a ladder often has to change a letter away from the
+ * destination and back, so many words share the best estimate.  Ties go
+ * to the word with fewer letters left to change, which is further along.
+ */
+bool WordLadderSolver::solveAStar(int from, int to, vector<int> &ladder) {
+  if (!begin(from, to, ladder)) {
+    return false;
+  }
+  open.clear();
+  greater<uint64_t> after;
+  seen[from] = stamp;
+  parent[from] = -1;
+  distance[from] = 0;
+  // entries are (estimate, letters left, word), in 24, 8 and 32 bits;
+  // letters left only breaks ties, so longer words share its top value
+  auto entry = [](uint32_t estimate, int left, int word) {
+    return uint64_t(estimate) << 40 | uint64_t(min(left, 255)) << 32 |
+           uint32_t(word);
+  };
+  int left = lettersToChange(from, to);
+  open.push_back(entry(uint32_t(left), left, from));
+  while (!open.empty()) {
+    pop_heap(open.begin(), open.end(), after);
+    uint64_t top = open.back();
+    open.pop_back();
+    int word = int(uint32_t(top));
+    uint32_t estimate = uint32_t(top >> 40);
+    if (estimate != distance[word] + uint32_t(lettersToChange(word, to))) {
+      continue; // a shorter route to word was found after this push
+    }
+    expanded++;
+    if (word == to) {
+      ladder.resize(distance[to] + 1);
+      trace(to, ladder.data() + ladder.size());
+      return true;
+    }
+    uint32_t steps = distance[word] + 1;
+    const uint32_t *neighbours = graph.neighbours(word);
+    int degree = graph.degree(word);
+    for (int i = 0; i < degree; i++) {
+      int next = int(neighbours[i]);
+      if (seen[next] != stamp || steps < distance[next]) {
+        seen[next] = stamp;
+        parent[next] = word;
+        distance[next] = steps;
+        int remaining = lettersToChange(next, to);
+        open.push_back(entry(steps + uint32_t(remaining), remaining, next));
+        push_heap(open.begin(), open.end(), after);
+      }
+    }
+  }
+  return false;
+}
+
+/*
+ * Yen's algorithm: each ladder after the first is the shortest of the
+ * candidates found by leaving some earlier ladder at one of its words,
+ * the spur, by a step no ladder with the same beginning has taken, and
+ * finishing with a shortest ladder that avoids the words before the
+ * spur.  Word numbers follow alphabetical order, so comparing ladders
+ * as vectors breaks ties between candidates of one length by spelling.
+ */
+int WordLadderSolver::findShortestLadders(int from, int to, int k,
+                                          vector<vector<int>> &ladders) {
+  ladders.clear();
+  vector<int> ladder;
+  if (k <= 0 || !solveBreadthFirst(from, to, ladder)) {
+    return 0;
+  }
+  uint32_t total = expanded;
+  ladders.push_back(ladder);
+  vector<vector<int>> candidates;
+  vector<int> root, banned, spur;
+  while (int(ladders.size()) < k) {
+    const vector<int> last = ladders.back();
+    for (size_t j = 0; j + 1 < last.size(); j++) {
+      root.assign(last.begin(), last.begin() + j);
+      banned.clear();
+      for (const vector<int> &found : ladders) {
+        if (found.size() > j + 1 &&
+            equal(last.begin(), last.begin() + j + 1, found.begin())) {
+          banned.push_back(found[j + 1]);
+        }
+      }
+      bool joined = begin(last[j], to, spur) &&
+                    search(last[j], to, root, banned, spur);
+      total += expanded;
+      if (!joined) {
+        continue;
+      }
+      root.insert(root.end(), spur.begin(), spur.end());
+      if (std::find(candidates.begin(), candidates.end(), root) ==
+          candidates.end()) {
+        candidates.push_back(root);
+      }
+    }
+    if (candidates.empty()) {
+      break;
+    }
+    auto next = candidates.begin();
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+      if (it->size() < next->size() ||
+          (it->size() == next->size() && *it < *next)) {
+        next = it;
+      }
+    }
+    ladders.push_back(*next);
+    candidates.erase(next);
+  }
+  expanded = total;
+  return int(ladders.size());
+}
+
+/*
+ * Searches breadth first back from to until it reaches from, which
+ * gives every word nearer to than from is its distance; a word on a
+ * shortest ladder is then followed by exactly the neighbours one step
+ * nearer, and every such step leads on to to, so a depth-first walk
+ * over those steps never backs out of a dead end.  Neighbours come in
+ * alphabetical order, so the ladders do too.
+ */
+int WordLadderSolver::findAllShortestLadders(int from, int to,
+                                             vector<vector<int>> &ladders,
+                                             int limit) {
+  ladders.clear();
+  vector<int> ladder;
+  if (limit <= 0 || !begin(from, to, ladder)) {
+    return 0;
+  }
+  seen[to] = stamp;
+  distance[to] = 0;
+  bool found = from == to;
+  queue[0] = to;
+  uint32_t head = 0, tail = 1;
+  while (head < tail && !found) {
+    int word = queue[head++];
+    expanded++;
+    const uint32_t *neighbours = graph.neighbours(word);
+    int degree = graph.degree(word);
+    for (int i = 0; i < degree; i++) {
+      int next = int(neighbours[i]);
+      if (seen[next] != stamp) {
+        seen[next] = stamp;
+        distance[next] = distance[word] + 1;
+        found = found || next == from;
+        queue[tail++] = next;
+      }
+    }
+  }
+  if (!found) {
+    return 0;
+  }
+
+  // ladder[i] is the i-th word of the ladder being spelled and tried[i]
+  // how many of its neighbours have been tried after it
+  uint32_t length = distance[from] + 1;
+  ladder.assign(length, from);
+  vector<int> tried(length, 0);
+  int depth = 0;
+  while (depth >= 0) {
+    int word = ladder[depth];
+    if (word == to) {
+      ladders.push_back(ladder);
+      if (int(ladders.size()) == limit) {
+        break;
+      }
+      depth--;
+      continue;
+    }
+    const uint32_t *neighbours = graph.neighbours(word);
+    int degree = graph.degree(word);
+    int &i = tried[depth];
+    while (i < degree && !(seen[neighbours[i]] == stamp &&
+                           distance[neighbours[i]] + 1 == distance[word])) {
+      i++;
+    }
+    if (i == degree) {
+      depth--;
+      continue;
+    }
+    ladder[depth + 1] = int(neighbours[i++]);
+    tried[++depth] = 0;
+  }
+  return int(ladders.size());
+}
+
+bool WordLadderSolver::solve(const string &start, const string &end,
+                             vector<string> &ladder, string &error) {
+  ladder.clear();
+  string first = start, last = end;
+  for (char &letter : first) {
+    letter = char(tolower((unsigned char)letter));
+  }
+  for (char &letter : last) {
+    letter = char(tolower((unsigned char)letter));
+  }
+  int from = graph.find(first), to = graph.find(last);
+  if (from == -1 || to == -1) {
+    error = "\"" + (from == -1 ? start : end) + "\" is not in the dictionary.";
+    return false;
+  }
+  if (first.size() != last.size()) {
+    error = "\"" + start + "\" and \"" + end + "\" differ in length, so no "
+            "word ladder connects them.";
+    return false;
+  }
+  vector<int> numbers;
+  if (!solveBidirectional(from, to, numbers)) {
+    error = "No word ladder connects them.";
+    return false;
+  }
+  for (int word : numbers) {
+    ladder.push_back(graph.getWord(word));
+  }
+  return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * File: word-ladder-solver.h
+ * --------------------------
+ * Defines a solver that finds word ladders in a WordGraph: a shortest one
+ * by breadth-first search, by breadth-first search from both ends at
+ * once, or by A* with the number of letters still to change as its
+ * heuristic; the k shortest ladders of any length; or every shortest
+ * one.
+ *
+ * A step changes one letter in place, so every word on a ladder has the
+ * length of its ends, and a query between words of different lengths is
+ * answered before any search starts.  The searches themselves follow the
+ * graph's neighbour lists by word number and look at no letters, except
+ * A*, which counts the letters a word still has to change.  A search
+ * from a short word usually reaches only a small share of the 127k words
+ * of dictionary.txt, so the solver keeps its per-word arrays from one
+ * query to the next and tells this query's words from older ones by a
+ * search number rather than clearing them.
+ *
+ * Nothing here depends on the Stanford library or the console, so a
+ * program can ask for ladders without anyone typing the words.
+ */
+
+#ifndef _word_ladder_solver_
+#define _word_ladder_solver_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "word-graph.h"
+
+class WordLadderSolver {
+public:
+  /**
+   * Creates a solver for the given graph, which must outlive it.  The
+   * graph may change between searches.
+   */
+  explicit WordLadderSolver(const WordGraph &graph);
+
+  /**
+   * Each of these stores the numbers of the words on a shortest ladder
+   * from the word numbered from to the word numbered to, both included,
+   * in ladder and returns true, or returns false, leaving ladder empty,
+   * if no ladder joins them or either number is not a word's.
+   */
+  bool solveBreadthFirst(int from, int to, std::vector<int> &ladder);
+  bool solveBidirectional(int from, int to, std::vector<int> &ladder);
+  bool solveAStar(int from, int to, std::vector<int> &ladder);
+
+  /**
+   * Stores up to k ladders from from to to in ladders, shortest first,
+   * none visiting a word twice, and returns how many it found.  These
+   * are the k shortest ladders, found by Yen's algorithm with one
+   * breadth-first search per word of each ladder found.
+   */
+  int findShortestLadders(int from, int to, int k,
+                          std::vector<std::vector<int>> &ladders);
+
+  /**
+   * Stores every shortest ladder from from to to in ladders, in
+   * alphabetical order, stopping once it has limit of them, and returns
+   * how many it stored.  Each ladder takes time in proportion to its
+   * length, however many words lie off every shortest ladder.
+   */
+  int findAllShortestLadders(int from, int to,
+                             std::vector<std::vector<int>> &ladders,
+                             int limit);
+
+  /**
+   * Looks up both words, in any case, and stores the words on a shortest
+   * ladder between them in ladder and returns true, or returns false and
+   * explains why in error if either is not in the graph, they differ in
+   * length or no ladder joins them.
+   */
+  bool solve(const std::string &start, const std::string &end,
+             std::vector<std::string> &ladder, std::string &error);
+
+  /**
+   * Returns the number of words the last search expanded.
+   */
+  uint32_t getExpandedCount() const { return expanded; }
+
+private:
+  const WordGraph &graph;
+  uint32_t words;
+  std::vector<uint32_t> seen;     // number of the latest search to reach a word
+  std::vector<int> parent;        // previous word on the ladder, or -1
+  std::vector<uint32_t> distance; // letters changed since the search's root
+  std::vector<int> queue;
+  std::vector<uint64_t> open; // A*'s heap, see solveAStar
+  uint32_t stamp;             // number of the current search
+  uint32_t expanded;
+
+  WordLadderSolver(const WordLadderSolver &original);
+  void operator=(const WordLadderSolver &rhs) const;
+
+  bool begin(int from, int to, std::vector<int> &ladder);
+  bool search(int from, int to, const std::vector<int> &blocked,
+              const std::vector<int> &banned, std::vector<int> &ladder);
+  int lettersToChange(int word, int to) const;
+  void trace(int word, int *end) const;
+};
+
+#endif
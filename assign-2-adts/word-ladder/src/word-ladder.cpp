@@ -4,18 +4,22 @@
  * Implements a program to find word ladders connecting pairs of words.
  */
 
+#include <sys/stat.h> // for stat
+
 #include <iostream>
+#include <string>
+#include <vector>
 using namespace std;
 
+#include "compact-lexicon.h"
 #include "console.h"
-#include "lexicon.h"
-#include "queue.h"
-#include "set.h"
 #include "simpio.h"
 #include "strlib.h"
 #include "vector.h"
+#include "word-graph.h"
+#include "word-ladder-solver.h"
 
-static string getWord(const Lexicon &english, const string &prompt) {
+static string getWord(const CompactLexicon &english, const string &prompt) {
   while (true) {
     string response = trim(toLowerCase(getLine(prompt)));
     if (response.empty() || english.contains(response))
@@ -25,56 +29,85 @@ static string getWord(const Lexicon &english, const string &prompt) {
   }
 }
 
-static bool wordUsed(const Vector<string> &partialLadder, const string &word) {
-  for (string aWord : partialLadder) {
-    if (word == aWord) {
-      return true;
-    }
+static void generateLadder(WordLadderSolver &solver, const string &start,
+                           const string &end) {
+  cout << "Here's where you'll search for a word ladder connecting \"" << start
+       << "\" to \"" << end << "\"." << endl;
+  vector<string> ladder;
+  string error;
+  if (!solver.solve(start, end, ladder, error)) {
+    cout << error << endl;
+    return;
   }
-  return false;
-}
-
-static void extendLadder(const Lexicon &english,
-                         const Vector<string> &prevLadder,
-                         Queue<Vector<string>> &ladderQueue) {
-  for (int jj = 0; jj < (int)prevLadder.back().length(); jj++) {
-    string newWord = prevLadder.back();
-    for (int ii = 0; ii < 26; ii++) {
-      newWord[jj] = 'a' + ii;
-      if (english.contains(newWord) && !wordUsed(prevLadder, newWord)) {
-        Vector<string> newLadder = prevLadder;
-        newLadder.add(newWord);
-        ladderQueue.enqueue(newLadder);
-      }
-    }
+  Vector<string> wordLadder;
+  for (const string &word : ladder) {
+    wordLadder += word;
   }
+  cout << wordLadder << endl;
 }
 
-static void generateLadder(const Lexicon &english, const string &start,
-                           const string &end) {
-  Vector<string> wordLadder;
-  wordLadder += start;
+static const string kEnglishLanguageDatafile = "dictionary.txt";
+static const string kEnglishLexiconDatafile = "dictionary.lexicon";
+static const string kWordGraphDatafile = "dictionary.graph";
 
-  Queue<Vector<string>> ladderQueue;
-  ladderQueue.enqueue(wordLadder);
-  while (!ladderQueue.isEmpty()) {
-    Vector<string> lastLadder = ladderQueue.dequeue();
-    if (lastLadder.back() == end) {
-      wordLadder = lastLadder;
-      break;
-    } else {
-      extendLadder(english, lastLadder, ladderQueue);
-    }
+// true if both files exist and the one at path was modified after the
+// one at than
+static bool isNewer(const string &path, const string &than) {
+  struct stat pathStatus, thanStatus;
+  return stat(path.c_str(), &pathStatus) == 0 &&
+         stat(than.c_str(), &thanStatus) == 0 &&
+         pathStatus.st_mtime > thanStatus.st_mtime;
+}
+
+/**
+ * Loads the dictionary from the binary lexicon saved by an earlier run,
+ * which needs no parsing, unless the word list has changed since; then
+ * reads the word list and saves the lexicon for later runs.  Returns
+ * false and describes the problem in error if the word list can't be
+ * read either.
+ */
+static bool loadEnglish(CompactLexicon &english, string &error) {
+  if (!isNewer(kEnglishLanguageDatafile, kEnglishLexiconDatafile) &&
+      english.load(kEnglishLexiconDatafile, error)) {
+    return true;
   }
+  if (!english.addWordsFromFile(kEnglishLanguageDatafile, error)) {
+    return false;
+  }
+  string ignored;
+  english.save(kEnglishLexiconDatafile, ignored); // the next run rereads
+  return true;
+}
 
-  cout << "Here's where you'll search for a word ladder connecting \"" << start
-       << "\" to \"" << end << "\"." << endl;
-  cout << wordLadder << endl;
+/**
+ * Loads the neighbour graph of the dictionary saved by an earlier run, or
+ * builds it and saves it for later runs if there is none, or if the one
+ * saved was built from a different dictionary.
+ */
+static void loadWordGraph(const CompactLexicon &english, WordGraph &graph) {
+  vector<string> words;
+  for (const string &word : english) {
+    words.push_back(word);
+  }
+  string error;
+  if (graph.load(kWordGraphDatafile, error) &&
+      graph.getFingerprint() == WordGraph::fingerprintOf(words)) {
+    return;
+  }
+  graph.build(words);
+  graph.save(kWordGraphDatafile, error); // if it fails, the next run rebuilds
 }
 
-static const string kEnglishLanguageDatafile = "dictionary.txt";
 static void playWordLadder() {
-  Lexicon english(kEnglishLanguageDatafile);
+  CompactLexicon english;
+  string error;
+  if (!loadEnglish(english, error)) {
+    cout << error << endl;
+    return;
+  }
+  WordGraph graph;
+  loadWordGraph(english, graph);
+  WordLadderSolver solver(graph);
   while (true) {
     string start =
         getWord(english, "Please enter the source word [return to quit]: ");
@@ -84,7 +117,7 @@ static void playWordLadder() {
         english, "Please enter the destination word [return to quit]: ");
     if (end.empty())
       break;
-    generateLadder(english, start, end);
+    generateLadder(solver, start, end);
   }
 }
 
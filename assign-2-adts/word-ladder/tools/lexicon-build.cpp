@@ -0,0 +1,47 @@
+/**
+ * File: lexicon-build.cpp
+ * -----------------------
+ * Converts a word list into a binary lexicon.
+ *
+ *   lexicon-build words.txt words.lexicon
+ *
+ * Reads the word list, one word per line, saves it as a binary lexicon,
+ * then loads the file back and checks that it holds exactly the words
+ * of the list before reporting its size.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "compact-lexicon.h"
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    cerr << "usage: lexicon-build words.txt words.lexicon" << endl;
+    return 1;
+  }
+  string source = argv[1], target = argv[2], error;
+  CompactLexicon built;
+  if (!built.addWordsFromFile(source, error) || !built.save(target, error)) {
+    cerr << error << endl;
+    return 1;
+  }
+
+  CompactLexicon saved;
+  if (!saved.load(target, error)) {
+    cerr << error << endl;
+    return 1;
+  }
+  vector<string> expected(built.begin(), built.end());
+  vector<string> found(saved.begin(), saved.end());
+  if (found != expected) {
+    cerr << target << " does not hold the words of " << source << endl;
+    return 1;
+  }
+  cout << target << ": " << saved.size() << " words, "
+       << saved.getNodeCount() << " nodes, " << saved.getEdgeCount()
+       << " edges, " << saved.getMemoryUsage() << " bytes" << endl;
+  return 0;
+}
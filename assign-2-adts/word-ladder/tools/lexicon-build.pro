@@ -0,0 +1,29 @@
+#####################################################################
+## Converts a word list into a binary lexicon                      ##
+#####################################################################
+#
+# Builds a console program that reads a word list, one word per line,
+# and saves it as the binary lexicon CompactLexicon::load maps into
+# memory, so neither Qt nor the Stanford library is needed:
+#
+#     cd tools && qmake lexicon-build.pro && make
+#     ./lexicon-build ../dictionary.txt ../dictionary.lexicon
+#
+# word-ladder saves the same file itself on its first run, so this is
+# only needed to prepare the file ahead of time.
+
+TEMPLATE = app
+TARGET = lexicon-build
+CONFIG += console c++14
+CONFIG -= qt app_bundle
+
+INCLUDEPATH *= $$PWD/../src/
+
+SOURCES *= $$PWD/lexicon-build.cpp
+SOURCES *= $$PWD/../src/compact-lexicon.cpp
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Wno-sign-compare
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
@@ -0,0 +1,223 @@
+/**
+ * File: word-ladder-query.cpp
+ * ---------------------------
+ * Answers word ladder queries without the console.
+ *
+ *   word-ladder-query [--dictionary path] [--graph path]
+ *                     [--method bfs|bidirectional|astar]
+ *                     [--shortest K | --all N] [--stats] [start end]...
+ *
+ * Loads the dictionary, ../dictionary.txt by default, and the neighbour
+ * graph saved from it, ../dictionary.graph by default, building the
+ * graph if that file is missing or from another dictionary.  Then finds
+ * a ladder for each pair of words on the command line, or for each line
+ * of standard input holding two words if there are none, and prints it
+ * on one line, words separated by spaces.  --shortest prints up to K
+ * ladders in order of length and --all up to N shortest ladders in
+ * alphabetical order, one per line, followed by a blank line.  A pair
+ * that no ladder connects prints the reason on standard error instead,
+ * and --stats prints the number of words each search expanded there too.
+ * The exit status is 0 only if every pair was connected.
+ */
+
+#include <cctype>
+#include <cerrno>  // for errno, ERANGE
+#include <climits> // for INT_MAX, INT_MIN
+#include <cstdlib> // for strtol
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "compact-lexicon.h"
+#include "word-graph.h"
+#include "word-ladder-solver.h"
+
+struct QueryOptions {
+  string dictionary = "../dictionary.txt";
+  string graph = "../dictionary.graph";
+  string method = "bidirectional";
+  int shortest = 0;
+  int all = 0;
+  bool stats = false;
+  vector<string> words;
+};
+
+static void usage() {
+  cerr << "usage: word-ladder-query [--dictionary path] [--graph path]"
+       << endl
+       << "                         [--method bfs|bidirectional|astar]"
+       << endl
+       << "                         [--shortest K | --all N] [--stats]"
+       << " [start end]..." << endl;
+}
+
+/*
+ * Stores the whole of value, read as a decimal number, in result and
+ * returns true, or returns false if value holds anything else or a
+ * number out of int's range.
+ */
+static bool parseInt(const string &value, int &result) {
+  char *end;
+  errno = 0;
+  long number = strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || errno == ERANGE || number < INT_MIN ||
+      number > INT_MAX) {
+    return false;
+  }
+  result = int(number);
+  return true;
+}
+
+static bool parseOptions(int argc, char **argv, QueryOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    string flag = argv[i];
+    if (flag.compare(0, 2, "--") != 0) {
+      options.words.push_back(flag);
+      continue;
+    }
+    if (flag == "--stats") {
+      options.stats = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << flag << " needs a value" << endl;
+      return false;
+    }
+    string value = argv[++i];
+    bool number = true;
+    if (flag == "--dictionary") {
+      options.dictionary = value;
+    } else if (flag == "--graph") {
+      options.graph = value;
+    } else if (flag == "--method") {
+      options.method = value;
+    } else if (flag == "--shortest") {
+      number = parseInt(value, options.shortest);
+    } else if (flag == "--all") {
+      number = parseInt(value, options.all);
+    } else {
+      cerr << "unknown option " << flag << endl;
+      return false;
+    }
+    if (!number) {
+      cerr << flag << " needs a number, not " << value << endl;
+      return false;
+    }
+  }
+  return options.words.size() % 2 == 0 && options.shortest >= 0 &&
+         options.all >= 0 && (options.shortest == 0 || options.all == 0) &&
+         (options.method == "bfs" || options.method == "bidirectional" ||
+          options.method == "astar");
+}
+
+/*
+ * Loads the graph saved from the dictionary, or builds it and saves it
+ * for later runs, as word-ladder does.
+ */
+static bool loadWordGraph(const QueryOptions &options, WordGraph &graph) {
+  CompactLexicon english;
+  string error;
+  if (!english.addWordsFromFile(options.dictionary, error)) {
+    cerr << error << endl;
+    return false;
+  }
+  vector<string> words(english.begin(), english.end());
+  if (graph.load(options.graph, error) &&
+      graph.getFingerprint() == WordGraph::fingerprintOf(words)) {
+    return true;
+  }
+  graph.build(words);
+  graph.save(options.graph, error); // if it fails, the next run rebuilds
+  return true;
+}
+
+static void printLadder(const WordGraph &graph, const vector<int> &ladder) {
+  for (size_t i = 0; i < ladder.size(); i++) {
+    cout << (i == 0 ? "" : " ") << graph.getWord(ladder[i]);
+  }
+  cout << endl;
+}
+
+/*
+ * Answers the query for one pair and returns true if a ladder connects
+ * them.
+ */
+static bool query(const QueryOptions &options, const WordGraph &graph,
+                  WordLadderSolver &solver, string start, string end) {
+  for (char &letter : start) {
+    letter = char(tolower((unsigned char)letter));
+  }
+  for (char &letter : end) {
+    letter = char(tolower((unsigned char)letter));
+  }
+  int from = graph.find(start), to = graph.find(end);
+  vector<vector<int>> ladders;
+  if (from != -1 && to != -1) {
+    if (options.shortest > 0) {
+      solver.findShortestLadders(from, to, options.shortest, ladders);
+    } else if (options.all > 0) {
+      solver.findAllShortestLadders(from, to, ladders, options.all);
+    } else {
+      vector<int> ladder;
+      bool found = options.method == "bfs"
+                       ? solver.solveBreadthFirst(from, to, ladder)
+                   : options.method == "astar"
+                       ? solver.solveAStar(from, to, ladder)
+                       : solver.solveBidirectional(from, to, ladder);
+      if (found) {
+        ladders.push_back(ladder);
+      }
+    }
+  }
+  if (options.stats) {
+    cerr << start << " " << end << ": " << solver.getExpandedCount()
+         << " words expanded" << endl;
+  }
+  if (ladders.empty()) {
+    // solve explains why, which only costs a search that has failed
+    vector<string> ignored;
+    string error;
+    solver.solve(start, end, ignored, error);
+    cerr << start << " " << end << ": " << error << endl;
+    return false;
+  }
+  for (const vector<int> &ladder : ladders) {
+    printLadder(graph, ladder);
+  }
+  if (options.shortest > 0 || options.all > 0) {
+    cout << endl;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  QueryOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    usage();
+    return 1;
+  }
+  WordGraph graph;
+  if (!loadWordGraph(options, graph)) {
+    return 1;
+  }
+  WordLadderSolver solver(graph);
+  bool connected = true;
+  if (!options.words.empty()) {
+    for (size_t i = 0; i < options.words.size(); i += 2) {
+      connected &= query(options, graph, solver, options.words[i],
+                         options.words[i + 1]);
+    }
+    return connected ? 0 : 1;
+  }
+  string line;
+  while (getline(cin, line)) {
+    istringstream pair(line);
+    string start, end;
+    if (pair >> start >> end) {
+      connected &= query(options, graph, solver, start, end);
+    }
+  }
+  return connected ? 0 : 1;
+}
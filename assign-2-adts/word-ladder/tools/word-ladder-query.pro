@@ -0,0 +1,33 @@
+#####################################################################
+## Answers word ladder queries from the command line               ##
+#####################################################################
+#
+# Builds a console program that finds ladders between pairs of words
+# given as arguments or read from standard input, with any of the
+# solver's searches, so neither Qt nor the Stanford library is needed:
+#
+#     cd tools && qmake word-ladder-query.pro && make
+#     ./word-ladder-query --shortest 5 cat dog
+#     ./word-ladder-query --stats < pairs.txt
+#
+# It loads and saves the same dictionary.graph word-ladder does.
+
+TEMPLATE = app
+TARGET = word-ladder-query
+CONFIG += console c++14
+CONFIG -= qt app_bundle
+
+INCLUDEPATH *= $$PWD/../src/
+
+SOURCES *= $$PWD/word-ladder-query.cpp
+SOURCES *= $$PWD/../src/compact-lexicon.cpp
+SOURCES *= $$PWD/../src/word-graph.cpp
+SOURCES *= $$PWD/../src/word-ladder-solver.cpp
+
+LIBS += -lpthread
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Wno-sign-compare
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3